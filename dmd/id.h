@@ -84,6 +84,7 @@ struct Id
     static Identifier *udaSection;
     static Identifier *udaOptStrategy;
     static Identifier *udaTarget;
+    static Identifier *udaTargetClones;
     static Identifier *udaAssumeUsed;
     static Identifier *udaCallingConvention;
     static Identifier *udaWeak;
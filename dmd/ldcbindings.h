@@ -11,6 +11,7 @@
 
 #include "root/array.h"
 #include "tokens.h"
+#include <cstdint>
 
 class AddrExp;
 class CommaExp;
@@ -21,6 +22,7 @@ class GccAsmStatement;
 class InlineAsmStatement;
 struct OutBuffer;
 class Parameter;
+class Type;
 
 Array<Parameter *> *createParameters();
 Array<Expression *> *createExpressions();
@@ -39,3 +41,8 @@ AddrExp *createAddrExp(Loc loc, Expression *e);
 
 // for gen/toir.cpp only:
 CommaExp *createCommaExp(Loc loc, Expression *e1, Expression *e2, bool generated = true);
+
+// for gen/typinf.cpp only:
+// Computes the GC pointer bitmap of a type, like __traits(getPointerBitmap)
+// minus the leading size, which is returned (UINT64_MAX on errors).
+uint64_t computePointerBitmap(Type *t, Array<uint64_t> *data);
@@ -35,13 +35,18 @@
 #include "driver/cl_options.h"
 #include "driver/cl_options_sanitizers.h"
 #include "driver/ldc-version.h"
+#include "dmd/globals.h"
 #include "gen/logger.h"
 #include "gen/optimizer.h"
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/Support/Chrono.h"
+#include "llvm/Support/Compression.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -161,6 +166,30 @@ llvm::cl::opt<RetrievalMode> cacheRecoveryMode(
         clEnumValN(RetrievalMode::SymLink, "symlink",
                    "Create a symbolic link to the cache file")));
 
+enum class CompressionMode { None, Zlib, Zstd };
+llvm::cl::opt<CompressionMode> cacheCompression(
+    "cache-compression", llvm::cl::ZeroOrMore,
+    llvm::cl::desc("Set the compression of new cache files (default: none). "
+                   "Compressed cache files are always retrieved by "
+                   "decompressing them, regardless of -cache-retrieval."),
+    llvm::cl::init(CompressionMode::None),
+    llvm::cl::values(
+        clEnumValN(CompressionMode::None, "none", "No compression"),
+        clEnumValN(CompressionMode::Zlib, "zlib", "zlib compression"),
+        clEnumValN(CompressionMode::Zstd, "zstd",
+                   "zstd compression (recommended)")));
+
+/// Statistics printed with -v.
+struct {
+  unsigned hits = 0;
+  unsigned misses = 0;
+  unsigned compressedHits = 0;
+  uint64_t storedBytes = 0;
+  uint64_t storedCompressedBytes = 0;
+  std::chrono::steady_clock::duration compressionTime{};
+  std::chrono::steady_clock::duration decompressionTime{};
+} statistics;
+
 bool isPruningEnabled() {
   if (pruneEnabled)
     return true;
@@ -208,12 +237,289 @@ public:
   }
 };
 
+/// The cache files are distributed across 256 shard subdirectories, named
+/// after the first 2 hex digits of the hash, to keep directories small.
+/// Compressed cache files get an additional `.z` extension.
+void storeRelativeCacheFileName(llvm::StringRef cacheObjectHash,
+                                llvm::SmallString<128> &relativePath,
+                                bool compressed) {
+  relativePath.clear();
+  llvm::sys::path::append(
+      relativePath, cacheObjectHash.take_front(2),
+      llvm::Twine("ircache_") + cacheObjectHash + "." +
+          llvm::StringRef(target.obj_ext.ptr, target.obj_ext.length) +
+          (compressed ? ".z" : ""));
+}
+
 void storeCacheFileName(llvm::StringRef cacheObjectHash,
-                        llvm::SmallString<128> &filePath) {
+                        llvm::SmallString<128> &filePath,
+                        bool compressed = false) {
+  llvm::SmallString<128> relativePath;
+  storeRelativeCacheFileName(cacheObjectHash, relativePath, compressed);
   filePath = opts::cacheDir;
-  llvm::sys::path::append(
-      filePath, llvm::Twine("ircache_") + cacheObjectHash + "." +
-                    llvm::StringRef(target.obj_ext.ptr, target.obj_ext.length));
+  llvm::sys::path::append(filePath, relativePath);
+}
+
+/// Appends an insertion (size > 0) or access (size == 0) event for a cache
+/// file to the index log, which is merged into the cache index when pruning
+/// (see driver/cache_pruning.d). Errors are ignored; such files are picked up
+/// by the next full rescan of the cache directory.
+void appendToIndexLog(llvm::StringRef cacheObjectHash, uint64_t size,
+                      bool compressed) {
+  using namespace std::chrono;
+
+  llvm::SmallString<128> logFile(opts::cacheDir);
+  llvm::sys::path::append(logFile, "ircache_index.log");
+
+  int FD;
+  if (llvm::sys::fs::openFileForWrite(logFile, FD, llvm::sys::fs::CD_OpenAlways,
+                                      llvm::sys::fs::OF_Append)) {
+    IF_LOG Logger::println("Failed to open the cache index log: %s",
+                           logFile.c_str());
+    return;
+  }
+
+  llvm::SmallString<128> relativePath;
+  storeRelativeCacheFileName(cacheObjectHash, relativePath, compressed);
+  const auto msecs =
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count();
+
+  // Write the whole line at once, so that lines appended concurrently by
+  // other compiler processes don't interleave.
+  llvm::SmallString<256> line;
+  llvm::raw_svector_ostream(line)
+      << static_cast<int64_t>(msecs) << ' ' << size << ' ' << relativePath
+      << '\n';
+  llvm::raw_fd_ostream os(FD, /*shouldClose=*/true, /*unbuffered=*/true);
+  os << line;
+}
+
+/// Compressed cache files start with a header consisting of this magic, the
+/// compression format (1 byte), 3 padding bytes and the uncompressed size
+/// (64-bit little-endian), followed by the compressed object file.
+constexpr llvm::StringLiteral compressedMagic = "LDCz";
+constexpr size_t compressedHeaderSize = 16;
+
+#if LDC_LLVM_VER >= 1600
+llvm::compression::Format getCompressionFormat(CompressionMode mode) {
+  return mode == CompressionMode::Zstd ? llvm::compression::Format::Zstd
+                                       : llvm::compression::Format::Zlib;
+}
+#endif
+
+/// Returns null if the compression mode is supported by LLVM.
+const char *getReasonIfUnsupported(CompressionMode mode) {
+  assert(mode != CompressionMode::None);
+#if LDC_LLVM_VER >= 1600
+  return llvm::compression::getReasonIfUnsupported(getCompressionFormat(mode));
+#else
+  if (mode == CompressionMode::Zstd)
+    return "LDC was built against LLVM < 16, which doesn't support zstd";
+  return llvm::compression::zlib::isAvailable()
+             ? nullptr
+             : "LLVM was not built with zlib support";
+#endif
+}
+
+void compressObjectFile(CompressionMode mode, llvm::ArrayRef<uint8_t> input,
+                        llvm::SmallVectorImpl<uint8_t> &output) {
+  const auto start = std::chrono::steady_clock::now();
+
+  output.resize(compressedHeaderSize);
+  std::copy(compressedMagic.begin(), compressedMagic.end(), output.begin());
+  output[4] = static_cast<uint8_t>(mode);
+  llvm::support::endian::write64le(output.data() + 8, input.size());
+
+  llvm::SmallVector<uint8_t, 0> compressed;
+#if LDC_LLVM_VER >= 1600
+  llvm::compression::compress(
+      llvm::compression::Params(getCompressionFormat(mode)), input, compressed);
+#else
+  llvm::compression::zlib::compress(input, compressed);
+#endif
+  output.append(compressed.begin(), compressed.end());
+
+  statistics.compressionTime += std::chrono::steady_clock::now() - start;
+}
+
+/// Returns an error message on failure.
+std::string decompressObjectFile(llvm::ArrayRef<uint8_t> input,
+                                 llvm::SmallVectorImpl<uint8_t> &output) {
+  const auto start = std::chrono::steady_clock::now();
+
+  if (input.size() < compressedHeaderSize ||
+      !llvm::StringRef(reinterpret_cast<const char *>(input.data()), 4)
+           .equals(compressedMagic)) {
+    return "invalid header";
+  }
+  const auto mode = static_cast<CompressionMode>(input[4]);
+  if (mode != CompressionMode::Zlib && mode != CompressionMode::Zstd)
+    return "unknown compression format";
+  if (const char *reason = getReasonIfUnsupported(mode))
+    return reason;
+  const auto uncompressedSize =
+      llvm::support::endian::read64le(input.data() + 8);
+
+  input = input.drop_front(compressedHeaderSize);
+#if LDC_LLVM_VER >= 1600
+  llvm::Error err = llvm::compression::decompress(
+      getCompressionFormat(mode), input, output, uncompressedSize);
+#else
+  llvm::Error err =
+      llvm::compression::zlib::uncompress(input, output, uncompressedSize);
+#endif
+  if (err)
+    return llvm::toString(std::move(err));
+
+  statistics.decompressionTime += std::chrono::steady_clock::now() - start;
+  return "";
+}
+
+/// Writes the decompressed cache file to the output file, unless the output
+/// file is up-to-date already.
+void retrieveCompressedObjectFile(llvm::StringRef cacheFile,
+                                  llvm::StringRef objectFile) {
+  auto cacheBuffer = llvm::MemoryBuffer::getFile(cacheFile);
+  if (!cacheBuffer) {
+    error(Loc(), "Failed to read the cached file: %s (errno %d: %s)",
+          cacheFile.str().c_str(), cacheBuffer.getError().value(),
+          cacheBuffer.getError().message().c_str());
+    fatal();
+  }
+
+  llvm::SmallVector<uint8_t, 0> decompressed;
+  const std::string errorMessage = decompressObjectFile(
+      llvm::arrayRefFromStringRef((*cacheBuffer)->getBuffer()), decompressed);
+  if (!errorMessage.empty()) {
+    error(Loc(), "Failed to decompress the cached file: %s (%s)",
+          cacheFile.str().c_str(), errorMessage.c_str());
+    fatal();
+  }
+  const auto contents = llvm::toStringRef(decompressed);
+
+  // See isUpToDateOutput() for the copy mode.
+  llvm::sys::fs::file_status outputStatus;
+  if (!llvm::sys::fs::status(objectFile, outputStatus, /*follow=*/false) &&
+      outputStatus.type() == llvm::sys::fs::file_type::regular_file) {
+    auto outputBuffer = llvm::MemoryBuffer::getFile(objectFile);
+    if (outputBuffer && (*outputBuffer)->getBuffer() == contents) {
+      IF_LOG Logger::println(
+          "Output file is up-to-date with cached object file: %s -> %s",
+          objectFile.str().c_str(), cacheFile.str().c_str());
+      return;
+    }
+  }
+
+  IF_LOG Logger::println("Decompress cached object file: %s -> %s",
+                         cacheFile.str().c_str(), objectFile.str().c_str());
+  llvm::sys::fs::remove(objectFile);
+  std::error_code errorcode;
+  llvm::raw_fd_ostream os(objectFile, errorcode, llvm::sys::fs::OF_None);
+  if (!errorcode) {
+    os << contents;
+    os.close();
+    errorcode = os.error();
+  }
+  if (errorcode) {
+    error(Loc(), "Failed to write the cached file: %s -> %s (errno %d: %s)",
+          cacheFile.str().c_str(), objectFile.str().c_str(), errorcode.value(),
+          errorcode.message().c_str());
+    fatal();
+  }
+}
+
+/// Returns true if `objectFile` already is what retrieving `cacheFile` with
+/// the selected retrieval mode would produce.
+bool isUpToDateOutput(llvm::StringRef cacheFile, llvm::StringRef objectFile) {
+  namespace fs = llvm::sys::fs;
+
+  fs::file_status outputStatus;
+  if (fs::status(objectFile, outputStatus, /*follow=*/false))
+    return false;
+  const bool isSymLink = outputStatus.type() == fs::file_type::symlink_file;
+
+  bool isSameFile = false;
+  if (fs::equivalent(cacheFile, objectFile, isSameFile))
+    return false;
+
+  switch (cacheRecoveryMode) {
+  case RetrievalMode::Copy: {
+    if (isSameFile || isSymLink)
+      return false;
+    auto cacheBuffer = llvm::MemoryBuffer::getFile(cacheFile);
+    auto outputBuffer = llvm::MemoryBuffer::getFile(objectFile);
+    return cacheBuffer && outputBuffer &&
+           (*cacheBuffer)->getBuffer() == (*outputBuffer)->getBuffer();
+  }
+  case RetrievalMode::HardLink:
+    return isSameFile && !isSymLink;
+  case RetrievalMode::AnyLink:
+    return isSameFile;
+  case RetrievalMode::SymLink:
+    return isSameFile && isSymLink;
+  }
+  llvm_unreachable("Unhandled cache retrieval mode");
+}
+
+/// Copies or links the cached object file to the output file.
+void retrieveObjectFile(const llvm::SmallString<128> &cacheFile,
+                        llvm::StringRef objectFile) {
+  // Remove the potentially pre-existing output file.
+  llvm::sys::fs::remove(objectFile);
+
+  switch (cacheRecoveryMode) {
+  case RetrievalMode::Copy: {
+    IF_LOG Logger::println("Copy cached object file: %s -> %s",
+                           cacheFile.c_str(), objectFile.str().c_str());
+    if (auto errorcode =
+            llvm::sys::fs::copy_file(cacheFile.c_str(), objectFile)) {
+      error(Loc(), "Failed to copy the cached file: %s -> %s (errno %d: %s)",
+            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
+            errorcode.message().c_str());
+      fatal();
+    }
+  } break;
+  case RetrievalMode::HardLink: {
+    IF_LOG Logger::println("HardLink output to cached object file: %s -> %s",
+                           objectFile.str().c_str(), cacheFile.c_str());
+    if (auto errorcode =
+            createHardLink(cacheFile.c_str(), objectFile.str().c_str())) {
+      error(Loc(),
+            "Failed to create a hard link to the cached file: %s -> %s (errno "
+            "%d: %s)",
+            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
+            errorcode.message().c_str());
+      fatal();
+    }
+  } break;
+  case RetrievalMode::AnyLink: {
+    IF_LOG Logger::println("Link output to cached object file: %s -> %s",
+                           objectFile.str().c_str(), cacheFile.c_str());
+    if (auto errorcode =
+            llvm::sys::fs::create_link(cacheFile.c_str(), objectFile)) {
+      error(
+          Loc(),
+          "Failed to create a link to the cached file: %s -> %s (errno %d: %s)",
+          cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
+          errorcode.message().c_str());
+      fatal();
+    }
+  } break;
+  case RetrievalMode::SymLink: {
+    IF_LOG Logger::println("SymLink output to cached object file: %s -> %s",
+                           objectFile.str().c_str(), cacheFile.c_str());
+    if (auto errorcode =
+            createSymLink(cacheFile.c_str(), objectFile.str().c_str())) {
+      error(Loc(),
+            "Failed to create a symbolic link to the cached file: %s -> %s "
+            "(errno %d: %s)",
+            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
+            errorcode.message().c_str());
+      fatal();
+    }
+  } break;
+  }
 }
 
 // Output to `hash_os` all commandline flags, and try to skip the ones that have
@@ -372,14 +678,18 @@ std::string cacheLookup(llvm::StringRef cacheObjectHash) {
     return "";
   }
 
-  llvm::SmallString<128> filePath;
-  storeCacheFileName(cacheObjectHash, filePath);
-  if (llvm::sys::fs::exists(filePath.c_str())) {
-    IF_LOG Logger::println("Cache object found! %s", filePath.c_str());
-    return filePath.str().str();
+  for (const bool compressed : {false, true}) {
+    llvm::SmallString<128> filePath;
+    storeCacheFileName(cacheObjectHash, filePath, compressed);
+    if (llvm::sys::fs::exists(filePath.c_str())) {
+      IF_LOG Logger::println("Cache object found! %s", filePath.c_str());
+      ++statistics.hits;
+      return filePath.str().str();
+    }
   }
 
   IF_LOG Logger::println("Cache object not found.");
+  ++statistics.misses;
   return "";
 }
 
@@ -388,10 +698,25 @@ void cacheObjectFile(llvm::StringRef objectFile,
   if (opts::cacheDir.empty())
     return;
 
-  if (!llvm::sys::fs::exists(opts::cacheDir)) {
-    if (auto errorcode = llvm::sys::fs::create_directories(opts::cacheDir)) {
+  const bool compress = cacheCompression != CompressionMode::None;
+  if (compress) {
+    if (const char *reason = getReasonIfUnsupported(cacheCompression)) {
+      error(Loc(), "-cache-compression=%s is not supported: %s",
+            cacheCompression.getValue() == CompressionMode::Zstd ? "zstd"
+                                                                 : "zlib",
+            reason);
+      fatal();
+    }
+  }
+
+  llvm::SmallString<128> cacheFile;
+  storeCacheFileName(cacheObjectHash, cacheFile, compress);
+
+  const auto shardDir = llvm::sys::path::parent_path(cacheFile);
+  if (!llvm::sys::fs::exists(shardDir)) {
+    if (auto errorcode = llvm::sys::fs::create_directories(shardDir)) {
       error(Loc(), "Unable to create cache directory: %s (errno %d: %s)",
-            opts::cacheDir.c_str(), errorcode.value(),
+            shardDir.str().c_str(), errorcode.value(),
             errorcode.message().c_str());
       fatal();
     }
@@ -401,9 +726,6 @@ void cacheObjectFile(llvm::StringRef objectFile,
   // to a temporary file and then rename that temp file to the cache entry
   // filename (rename is atomic).
 
-  llvm::SmallString<128> cacheFile;
-  storeCacheFileName(cacheObjectHash, cacheFile);
-
   llvm::SmallString<128> tempFile;
   if (auto errorcode = llvm::sys::fs::createUniqueFile(
           llvm::Twine(cacheFile) + ".tmp%%%%%%%", tempFile)) {
@@ -414,14 +736,47 @@ void cacheObjectFile(llvm::StringRef objectFile,
     fatal();
   }
 
-  IF_LOG Logger::println("Copy object file to temp file: %s to %s",
-                         objectFile.str().c_str(), tempFile.c_str());
-  if (auto errorcode = llvm::sys::fs::copy_file(objectFile, tempFile.c_str())) {
-    error(Loc(),
-          "Failed to copy object file to cache: %s to %s (errno %d: %s)",
-          objectFile.str().c_str(), tempFile.c_str(), errorcode.value(),
-          errorcode.message().c_str());
-    fatal();
+  if (compress) {
+    IF_LOG Logger::println("Compress object file to temp file: %s to %s",
+                           objectFile.str().c_str(), tempFile.c_str());
+    std::error_code errorcode;
+    auto objectBuffer = llvm::MemoryBuffer::getFile(objectFile);
+    if (objectBuffer) {
+      llvm::SmallVector<uint8_t, 0> compressed;
+      compressObjectFile(
+          cacheCompression,
+          llvm::arrayRefFromStringRef((*objectBuffer)->getBuffer()),
+          compressed);
+      statistics.storedBytes += (*objectBuffer)->getBufferSize();
+      statistics.storedCompressedBytes += compressed.size();
+
+      llvm::raw_fd_ostream os(tempFile, errorcode, llvm::sys::fs::OF_None);
+      if (!errorcode) {
+        os << llvm::toStringRef(compressed);
+        os.close();
+        errorcode = os.error();
+      }
+    } else {
+      errorcode = objectBuffer.getError();
+    }
+    if (errorcode) {
+      error(Loc(),
+            "Failed to compress object file to cache: %s to %s (errno %d: %s)",
+            objectFile.str().c_str(), tempFile.c_str(), errorcode.value(),
+            errorcode.message().c_str());
+      fatal();
+    }
+  } else {
+    IF_LOG Logger::println("Copy object file to temp file: %s to %s",
+                           objectFile.str().c_str(), tempFile.c_str());
+    if (auto errorcode =
+            llvm::sys::fs::copy_file(objectFile, tempFile.c_str())) {
+      error(Loc(),
+            "Failed to copy object file to cache: %s to %s (errno %d: %s)",
+            objectFile.str().c_str(), tempFile.c_str(), errorcode.value(),
+            errorcode.message().c_str());
+      fatal();
+    }
   }
   IF_LOG Logger::println("Rename temp file to cache file: %s to %s",
                          tempFile.c_str(), cacheFile.c_str());
@@ -433,6 +788,10 @@ void cacheObjectFile(llvm::StringRef objectFile,
           errorcode.message().c_str());
     fatal();
   }
+
+  uint64_t size = 0;
+  llvm::sys::fs::file_size(cacheFile, size);
+  appendToIndexLog(cacheObjectHash, size, compress);
 }
 
 void recoverObjectFile(llvm::StringRef cacheObjectHash,
@@ -440,60 +799,22 @@ void recoverObjectFile(llvm::StringRef cacheObjectHash,
   llvm::SmallString<128> cacheFile;
   storeCacheFileName(cacheObjectHash, cacheFile);
 
-  // Remove the potentially pre-existing output file.
-  llvm::sys::fs::remove(objectFile);
-
-  switch (cacheRecoveryMode) {
-  case RetrievalMode::Copy: {
-    IF_LOG Logger::println("Copy cached object file: %s -> %s",
-                           cacheFile.c_str(), objectFile.str().c_str());
-    if (auto errorcode =
-            llvm::sys::fs::copy_file(cacheFile.c_str(), objectFile)) {
-      error(Loc(), "Failed to copy the cached file: %s -> %s (errno %d: %s)",
-            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
-            errorcode.message().c_str());
-      fatal();
-    }
-  } break;
-  case RetrievalMode::HardLink: {
-    IF_LOG Logger::println("HardLink output to cached object file: %s -> %s",
-                           objectFile.str().c_str(), cacheFile.c_str());
-    if (auto errorcode =
-            createHardLink(cacheFile.c_str(), objectFile.str().c_str())) {
-      error(Loc(),
-            "Failed to create a hard link to the cached file: %s -> %s (errno "
-            "%d: %s)",
-            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
-            errorcode.message().c_str());
-      fatal();
-    }
-  } break;
-  case RetrievalMode::AnyLink: {
-    IF_LOG Logger::println("Link output to cached object file: %s -> %s",
-                           objectFile.str().c_str(), cacheFile.c_str());
-    if (auto errorcode =
-            llvm::sys::fs::create_link(cacheFile.c_str(), objectFile)) {
-      error(
-          Loc(),
-          "Failed to create a link to the cached file: %s -> %s (errno %d: %s)",
-          cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
-          errorcode.message().c_str());
-      fatal();
-    }
-  } break;
-  case RetrievalMode::SymLink: {
-    IF_LOG Logger::println("SymLink output to cached object file: %s -> %s",
+  // Prefer an uncompressed cache file, which can be linked to.
+  const bool compressed = !llvm::sys::fs::exists(cacheFile);
+  if (compressed) {
+    storeCacheFileName(cacheObjectHash, cacheFile, /*compressed=*/true);
+    ++statistics.compressedHits;
+    retrieveCompressedObjectFile(cacheFile, objectFile);
+  } else if (isUpToDateOutput(cacheFile, objectFile)) {
+    // Leave an up-to-date pre-existing output file untouched. With the
+    // default copy mode, this also preserves its timestamp, so that build
+    // systems which only consider a target as changed if its output actually
+    // changed (e.g., Ninja's `restat`) can skip the steps depending on it.
+    IF_LOG Logger::println("Output file is up-to-date with cached object file: "
+                           "%s -> %s",
                            objectFile.str().c_str(), cacheFile.c_str());
-    if (auto errorcode =
-            createSymLink(cacheFile.c_str(), objectFile.str().c_str())) {
-      error(Loc(),
-            "Failed to create a symbolic link to the cached file: %s -> %s "
-            "(errno %d: %s)",
-            cacheFile.c_str(), objectFile.str().c_str(), errorcode.value(),
-            errorcode.message().c_str());
-      fatal();
-    }
-  } break;
+  } else {
+    retrieveObjectFile(cacheFile, objectFile);
   }
 
   // We reset the modification time to "now" such that the pruning algorithm
@@ -519,6 +840,34 @@ void recoverObjectFile(llvm::StringRef cacheObjectHash,
 
     close(FD);
   }
+
+  appendToIndexLog(cacheObjectHash, 0, compressed);
+}
+
+void printStatistics() {
+  using namespace std::chrono;
+
+  if (opts::cacheDir.empty() || (!statistics.hits && !statistics.misses))
+    return;
+
+  message("cache     %u hits (%u compressed), %u misses", statistics.hits,
+          statistics.compressedHits, statistics.misses);
+  if (statistics.storedBytes) {
+    message("cache     compressed %llu bytes to %llu bytes (%.1fx) in %lld ms",
+            static_cast<unsigned long long>(statistics.storedBytes),
+            static_cast<unsigned long long>(statistics.storedCompressedBytes),
+            static_cast<double>(statistics.storedBytes) /
+                statistics.storedCompressedBytes,
+            static_cast<long long>(
+                duration_cast<milliseconds>(statistics.compressionTime)
+                    .count()));
+  }
+  if (statistics.compressedHits) {
+    message("cache     decompressed in %lld ms",
+            static_cast<long long>(
+                duration_cast<milliseconds>(statistics.decompressionTime)
+                    .count()));
+  }
 }
 
 void pruneCache() {
@@ -26,6 +26,9 @@ void cacheObjectFile(llvm::StringRef objectFile,
 void recoverObjectFile(llvm::StringRef cacheObjectHash,
                        llvm::StringRef objectFile);
 
+/// Print hit/miss and compression statistics (for -v).
+void printStatistics();
+
 /// Prune the cache to avoid filling up disk space.
 void pruneCache();
 }
@@ -219,6 +219,16 @@ cl::opt<bool> emitDwarfDebugInfo(
     "gdwarf", cl::ZeroOrMore,
     cl::desc("Emit DWARF debuginfo (instead of CodeView) for MSVC targets"));
 
+cl::opt<bool> splitDwarf(
+    "gsplit-dwarf", cl::ZeroOrMore,
+    cl::desc("Write most of the DWARF debuginfo to a separate .dwo file next "
+             "to each object file (ELF targets)"));
+
+cl::opt<bool> debugTypeUnits(
+    "fdebug-types-section", cl::ZeroOrMore,
+    cl::desc("Emit the DWARF debuginfo of structs and classes in type units, "
+             "deduplicated by the linker (ELF targets)"));
+
 cl::opt<bool> noAsm("noasm", cl::desc("Disallow use of inline assembler"),
                     cl::ZeroOrMore);
 
@@ -582,6 +592,17 @@ cl::opt<bool>
     fSplitStack("fsplit-stack", cl::ZeroOrMore,
                 cl::desc("Use segmented stack (see Clang documentation)"));
 
+cl::opt<bool> fStrictAliasing(
+    "fstrict-aliasing", cl::ZeroOrMore,
+    cl::desc("Emit type-based alias analysis metadata, assuming that scalars "
+             "aren't accessed through lvalues of differently sized or "
+             "integral vs. floating-point/pointer types (experimental)"));
+
+cl::opt<bool> fTLSNoScan(
+    "ftls-noscan", cl::ZeroOrMore,
+    cl::desc("ELF: Emit zero-initialized thread-local variables without "
+             "pointers into a separate TLS section not scanned by the GC"));
+
 cl::opt<bool, true>
     allinst("allinst", cl::ZeroOrMore, cl::location(global.params.allInst),
             cl::desc("Generate code for all template instantiations"));
@@ -46,6 +46,8 @@ extern cl::list<std::string> runargs;
 extern cl::opt<bool> invokedByLDMD;
 extern cl::opt<bool> compileOnly;
 extern cl::opt<bool> emitDwarfDebugInfo;
+extern cl::opt<bool> splitDwarf;
+extern cl::opt<bool> debugTypeUnits;
 extern cl::opt<bool> noAsm;
 extern cl::opt<bool> dontWriteObj;
 extern cl::opt<std::string> objectFile;
@@ -103,6 +105,8 @@ extern cl::opt<bool> fNoExceptions;
 extern cl::opt<bool> fNoModuleInfo;
 extern cl::opt<bool> fNoRTTI;
 extern cl::opt<bool> fSplitStack;
+extern cl::opt<bool> fStrictAliasing;
+extern cl::opt<bool> fTLSNoScan;
 
 // Arguments to -d-debug
 extern std::vector<std::string> debugArgs;
@@ -109,6 +109,49 @@ cl::opt<CFProtectionType> fCFProtection(
                ),
     cl::init(CFProtectionType::None));
 
+cl::opt<unsigned> fProfileInstrSamplingPeriod(
+    "fprofile-instr-sampling-period", cl::ZeroOrMore, cl::value_desc("N"),
+    cl::desc("With -fprofile-instr-generate, only count the first "
+             "-fprofile-instr-sampling-burst of every N invocations of "
+             "instrumented functions per thread (default: 0 = count all). "
+             "Rarely executed code may end up with zero counts"));
+
+cl::opt<unsigned> fProfileInstrSamplingBurst(
+    "fprofile-instr-sampling-burst", cl::ZeroOrMore, cl::init(200),
+    cl::value_desc("M"),
+    cl::desc("Number of consecutive invocations counted per sampling period "
+             "(default: 200)"));
+
+static cl::opt<bool> fSplitMachineFunctions(
+    "fsplit-machine-functions", cl::ZeroOrMore,
+    cl::desc("Split functions into hot and cold parts based on the PGO profile "
+             "(x86_64 ELF targets only)"));
+
+cl::opt<bool> fProfileSymbolOrder(
+    "fprofile-symbol-order", cl::ZeroOrMore,
+    cl::desc("Order the functions by hotness according to the PGO profile "
+             "when linking with LLD"));
+
+cl::opt<bool> fDebugInfoForProfiling(
+    "fdebug-info-for-profiling", cl::ZeroOrMore,
+    cl::desc("Emit extra debug info (e.g., discriminators) to make sample "
+             "profiles collected with -g more accurate"));
+
+bool splitMachineFunctions(const llvm::Triple &triple) {
+  if (!fSplitMachineFunctions || !isUsingPGOProfile()) {
+    return false;
+  }
+
+  // The cold parts are moved to ELF .text.split sections.
+  if (!triple.isOSBinFormatELF() || triple.getArch() != llvm::Triple::x86_64) {
+    warning(Loc(), "`-fsplit-machine-functions` is only supported for x86_64 "
+                   "ELF targets, ignoring");
+    return false;
+  }
+
+  return true;
+}
+
 void initializeInstrumentationOptionsFromCmdline(const llvm::Triple &triple) {
   if (ASTPGOInstrGenFile.getNumOccurrences() > 0) {
     pgoMode = PGO_ASTBasedInstr;
@@ -136,6 +179,18 @@ void initializeInstrumentationOptionsFromCmdline(const llvm::Triple &triple) {
     global.params.datafileInstrProf = fromPathString(SamplePGOInstrUseFile).ptr;
   }
 
+  if (fProfileInstrSamplingPeriod != 0) {
+    if (pgoMode != PGO_ASTBasedInstr) {
+      warning(Loc(), "`-fprofile-instr-sampling-period` requires "
+                     "`-fprofile-instr-generate`, ignoring");
+      fProfileInstrSamplingPeriod = 0;
+    } else if (fProfileInstrSamplingBurst == 0 ||
+               fProfileInstrSamplingBurst >= fProfileInstrSamplingPeriod) {
+      error(Loc(), "`-fprofile-instr-sampling-burst` must be between 1 and "
+                   "the sampling period");
+    }
+  }
+
   if (dmdFunctionTrace)
     global.params.trace = true;
 
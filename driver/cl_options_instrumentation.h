@@ -64,4 +64,20 @@ inline bool isUsingSampleBasedPGOProfile() {
   return pgoMode == PGO_SampleBasedUse;
 }
 
+/// Sampling of the AST-based PGO counter updates, see
+/// CodeGenPGO::emitSampling().
+extern cl::opt<unsigned> fProfileInstrSamplingPeriod;
+extern cl::opt<unsigned> fProfileInstrSamplingBurst;
+
+/// Whether to split off the cold blocks of functions based on the PGO
+/// profile (machine function splitting).
+bool splitMachineFunctions(const llvm::Triple &triple);
+
+/// Whether to pass a symbol ordering file generated from the PGO profile to
+/// the linker.
+extern cl::opt<bool> fProfileSymbolOrder;
+
+/// Whether to emit the extra debug info needed for accurate sample profiles.
+extern cl::opt<bool> fDebugInfoForProfiling;
+
 } // namespace opts
@@ -23,6 +23,7 @@
 #include "gen/dynamiccompile.h"
 #include "gen/logger.h"
 #include "gen/modules.h"
+#include "gen/multiversioning.h"
 #include "gen/runtime.h"
 #include "gen/tollvm.h"
 #include "ir/irdsymbol.h"
@@ -245,6 +246,7 @@ void CodeGenerator::writeAndFreeLLModule(const char *filename) {
   ir_->DBuilder.Finalize();
   generateBitcodeForDynamicCompile(ir_);
 
+  emitTargetClones(*ir_);
   emitLLVMUsedArray(*ir_);
   emitLinkerOptions(*ir_);
 
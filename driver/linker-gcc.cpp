@@ -20,8 +20,11 @@
 #include "gen/logger.h"
 #include "gen/optimizer.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 
@@ -86,8 +89,13 @@ private:
   void addLTOGoldPluginFlags(bool requirePlugin);
   void addDarwinLTOFlags();
   void addLTOLinkFlags();
+  void addProfileSymbolOrderingFlags();
+  bool isLld();
   bool isLldDefaultLinker();
 
+  // removes the temporary symbol ordering file after linking
+  llvm::FileRemover symbolOrderingFileRemover;
+
   virtual void addLdFlag(const llvm::Twine &flag) {
     args.push_back(("-Wl," + flag).str());
   }
@@ -206,8 +214,7 @@ void ArgsBuilder::addDarwinLTOFlags() {
 
 /// Adds the required linker flags for LTO builds to args.
 void ArgsBuilder::addLTOLinkFlags() {
-  bool isLld = opts::linker == "lld" || useInternalLLDForLinking() ||
-               (opts::linker.empty() && isLldDefaultLinker());
+  const bool isLld = this->isLld();
   if (global.params.targetTriple->isOSLinux() ||
       global.params.targetTriple->isOSFreeBSD() ||
       global.params.targetTriple->isOSNetBSD() ||
@@ -226,6 +233,92 @@ void ArgsBuilder::addLTOLinkFlags() {
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+// Writes the functions executed according to the PGO profile to `path`, the
+// hottest first, in the format of LLD's --symbol-ordering-file.
+bool writeSymbolOrderingFile(const char *profilePath, llvm::StringRef path) {
+  auto readerOrErr =
+      llvm::IndexedInstrProfReader::create(profilePath
+#if LDC_LLVM_VER >= 1700
+                                           ,
+                                           *llvm::vfs::getRealFileSystem()
+#endif
+      );
+  if (auto E = readerOrErr.takeError()) {
+    handleAllErrors(std::move(E), [&](const llvm::ErrorInfoBase &EI) {
+      warning(Loc(), "Could not read profile file '%s': %s", profilePath,
+              EI.message().c_str());
+    });
+    return false;
+  }
+  auto &reader = *readerOrErr.get();
+
+  llvm::StringMap<uint64_t> entryCounts;
+  for (const auto &record : reader) {
+    if (record.Counts.empty() || record.Counts[0] == 0)
+      continue;
+    // Strip the source file prefix of the names of internal functions.
+    llvm::StringRef name = record.Name;
+    const size_t sep = name.find_last_of(":;");
+    if (sep != llvm::StringRef::npos)
+      name = name.substr(sep + 1);
+    uint64_t &count = entryCounts[name];
+    count = std::max(count, record.Counts[0]);
+  }
+  if (reader.hasError()) {
+    warning(Loc(), "Could not read profile file '%s': %s", profilePath,
+            llvm::toString(reader.getError()).c_str());
+    return false;
+  }
+
+  std::vector<std::pair<llvm::StringRef, uint64_t>> symbols;
+  for (const auto &entry : entryCounts)
+    symbols.emplace_back(entry.getKey(), entry.getValue());
+  std::sort(symbols.begin(), symbols.end(), [](const auto &a, const auto &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+
+  std::error_code errinfo;
+  llvm::raw_fd_ostream os(path, errinfo, llvm::sys::fs::OF_Text);
+  if (errinfo) {
+    warning(Loc(), "cannot write file '%s': %s", path.str().c_str(),
+            errinfo.message().c_str());
+    return false;
+  }
+  for (const auto &symbol : symbols)
+    os << symbol.first << '\n';
+  return true;
+}
+} // anonymous namespace
+
+/// Makes LLD lay out the functions by hotness according to the PGO profile,
+/// to reduce i-cache and iTLB misses.
+void ArgsBuilder::addProfileSymbolOrderingFlags() {
+  if (!isLld()) {
+    warning(Loc(), "`-fprofile-symbol-order` requires linking with LLD "
+                   "(`-link-internally` or `--linker=lld`), ignoring");
+    return;
+  }
+
+  llvm::SmallString<128> path;
+  if (llvm::sys::fs::createTemporaryFile("ldc-symbol-order", "txt", path))
+    return;
+  symbolOrderingFileRemover.setFile(path);
+  if (!writeSymbolOrderingFile(global.params.datafileInstrProf, path))
+    return;
+
+  addLdFlag(("--symbol-ordering-file=" + path).str());
+  // the profile may contain functions not linked into this binary
+  addLdFlag("--no-warn-symbol-ordering");
+}
+
+bool ArgsBuilder::isLld() {
+  return opts::linker == "lld" || useInternalLLDForLinking() ||
+         (opts::linker.empty() && isLldDefaultLinker());
+}
+
 bool ArgsBuilder::isLldDefaultLinker() {
   auto triple = global.params.targetTriple;
   if (triple->isOSFreeBSD()) {
@@ -623,6 +716,11 @@ void ArgsBuilder::build(llvm::StringRef outputPath,
     }
   }
 
+  if (opts::fProfileSymbolOrder && opts::isUsingPGOProfile() &&
+      triple.isOSBinFormatELF()) {
+    addProfileSymbolOrderingFlags();
+  }
+
   const auto explicitPlatformLibs = getExplicitPlatformLibs();
 #if LDC_LLVM_VER >= 1600
   if (explicitPlatformLibs.has_value()) {
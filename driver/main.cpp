@@ -1188,11 +1188,32 @@ int cppmain() {
 
   global.params.dwarfVersion = gTargetMachine->Options.MCOptions.DwarfVersion;
 
-  // -gdwarf implies -g if not specified explicitly
-  if (opts::emitDwarfDebugInfo && global.params.symdebug == 0) {
+  // -gdwarf and -gsplit-dwarf imply -g if not specified explicitly
+  if ((opts::emitDwarfDebugInfo || opts::splitDwarf) &&
+      global.params.symdebug == 0) {
     global.params.symdebug = 1;
   }
 
+  if ((opts::splitDwarf || opts::debugTypeUnits) &&
+      !triple->isOSBinFormatELF()) {
+    warning(Loc(), "`-gsplit-dwarf` and `-fdebug-types-section` are only "
+                   "supported for ELF targets, ignoring");
+  } else {
+    // The objects are emitted by the linker plugin with LTO.
+    if (opts::splitDwarf && opts::isUsingLTO()) {
+      warning(Loc(), "`-gsplit-dwarf` is not supported with LTO, ignoring");
+    }
+    if (opts::debugTypeUnits) {
+      // LLVM emits a type unit for each aggregate with a unique identifier
+      // (the mangled D type, see DIBuilder::CreateCompositeType()).
+      auto &map = cl::getRegisteredOptions();
+      auto it = map.find("generate-type-units");
+      if (it != map.end()) {
+        it->second->addOccurrence(0, "generate-type-units", "");
+      }
+    }
+  }
+
   if (triple->isOSWindows()) {
     const auto v = opts::symbolVisibility.getValue();
     global.params.dllexport =
@@ -1217,6 +1238,10 @@ int cppmain() {
 
   opts::initializeInstrumentationOptionsFromCmdline(*triple);
 
+  if (opts::splitMachineFunctions(*triple)) {
+    gTargetMachine->Options.EnableMachineFunctionSplitter = true;
+  }
+
   loadAllPlugins();
 
   const int status = mars_tryMain(global.params, files);
@@ -1311,6 +1336,9 @@ void codegenModules(Modules &modules) {
       global.params.link = false;
   }
 
+  if (global.params.v.verbose)
+    cache::printStatistics();
+
   {
     dmd::TimeTraceScope timeScope("Prune object file cache");
     cache::pruneCache();
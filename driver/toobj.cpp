@@ -30,6 +30,7 @@
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -109,6 +110,27 @@ void codegenModule(llvm::TargetMachine &Target, llvm::Module &m,
     fatal();
   }
 
+  // With -gsplit-dwarf, most of the debuginfo of object files goes to a .dwo
+  // file next to it. The .dwo name is specific to this object, so don't leave
+  // it in the options of the shared TargetMachine.
+  llvm::SaveAndRestore<std::string> restoreSplitDwarfFile(
+      Target.Options.MCOptions.SplitDwarfFile);
+  std::unique_ptr<llvm::ToolOutputFile> dwoOut;
+  if (opts::splitDwarf && global.params.symdebug && !opts::isUsingLTO() &&
+      fileType == CGFT_ObjectFile && cb == ComputeBackend::None &&
+      Target.getTargetTriple().isOSBinFormatELF()) {
+    llvm::SmallString<128> dwoPath(filename);
+    llvm::sys::path::replace_extension(dwoPath, "dwo");
+    dwoOut = std::make_unique<llvm::ToolOutputFile>(dwoPath, errinfo,
+                                                    llvm::sys::fs::OF_None);
+    if (errinfo) {
+      error(Loc(), "cannot write file '%s': %s", dwoPath.c_str(),
+            errinfo.message().c_str());
+      fatal();
+    }
+    Target.Options.MCOptions.SplitDwarfFile = std::string(dwoPath.str());
+  }
+
   // The DataLayout is already set at the module (in module.cpp,
   // method Module::genLLVMModule())
   // FIXME: Introduce new command line switch default-data-layout to
@@ -129,7 +151,7 @@ void codegenModule(llvm::TargetMachine &Target, llvm::Module &m,
   if (Target.addPassesToEmitFile(
           Passes,
           out.os(), // Output file
-          nullptr,  // DWO output file
+          dwoOut ? &dwoOut->os() : nullptr, // DWO output file
           // Always generate assembly for ptx as it is an assembly format
           // The PTX backend fails if we pass anything else.
           (cb == ComputeBackend::NVPTX) ? CGFT_AssemblyFile : fileType
@@ -149,6 +171,9 @@ void codegenModule(llvm::TargetMachine &Target, llvm::Module &m,
   }
 
   out.keep();
+  if (dwoOut) {
+    dwoOut->keep();
+  }
 }
 
 }
@@ -341,7 +366,9 @@ void writeModule(llvm::Module *m, const char *filename) {
   // Use cached object code if possible.
   // TODO: combine LDC's cache and LTO (the advantage is skipping the IR
   // optimization).
-  const bool useIR2ObjCache = !opts::cacheDir.empty() && outputObj && !doLTO;
+  // The cache doesn't know about .dwo files.
+  const bool useIR2ObjCache =
+      !opts::cacheDir.empty() && outputObj && !doLTO && !opts::splitDwarf;
   llvm::SmallString<32> moduleHash;
   if (useIR2ObjCache) {
     dmd::TimeTraceScope timeScope("Check object cache", filename);
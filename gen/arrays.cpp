@@ -23,6 +23,7 @@
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
 #include "gen/logger.h"
+#include "gen/passes/metadata.h"
 #include "gen/runtime.h"
 #include "gen/tollvm.h"
 #include "ir/irfunction.h"
@@ -1049,7 +1050,7 @@ void DtoIndexBoundsCheck(Loc loc, DValue *arr, DValue *index) {
 
   llvm::BasicBlock *okbb = gIR->insertBB("bounds.ok");
   llvm::BasicBlock *failbb = gIR->insertBBAfter(okbb, "bounds.fail");
-  gIR->ir->CreateCondBr(cond, okbb, failbb);
+  markAsBoundsCheck(gIR->ir->CreateCondBr(cond, okbb, failbb));
 
   // set up failbb to call the array bounds error runtime function
   gIR->ir->SetInsertPoint(failbb);
@@ -1059,6 +1060,10 @@ void DtoIndexBoundsCheck(Loc loc, DValue *arr, DValue *index) {
   gIR->ir->SetInsertPoint(okbb);
 }
 
+void markAsBoundsCheck(llvm::BranchInst *br) {
+  br->setMetadata(LDC_BOUNDSCHECK_MD, llvm::MDNode::get(br->getContext(), {}));
+}
+
 static void emitRangeErrorImpl(IRState *irs, Loc loc, const char *cAssertMsg,
                                const char *dFnName,
                                llvm::ArrayRef<LLValue *> extraArgs) {
@@ -78,6 +78,10 @@ DValue *DtoCastArray(Loc loc, DValue *val, Type *to);
 // generates an array bounds check
 void DtoIndexBoundsCheck(Loc loc, DValue *arr, DValue *index);
 
+/// Tags a conditional branch to the range error as bounds check, making it
+/// subject to the bounds check elimination pass.
+void markAsBoundsCheck(llvm::BranchInst *br);
+
 /// Inserts a call to the druntime function that throws the range error, with
 /// the given location.
 void emitRangeError(IRState *irs, Loc loc);
@@ -23,6 +23,7 @@
 #include "dmd/target.h"
 #include "dmd/template.h"
 #include "driver/cl_options.h"
+#include "driver/cl_options_instrumentation.h"
 #include "driver/ldc-version.h"
 #include "gen/functions.h"
 #include "gen/irstate.h"
@@ -913,8 +914,9 @@ void DIBuilder::EmitCompileUnit(Module *m) {
       1,                       // Runtime Version TODO
       llvm::StringRef(),       // SplitName
       getDebugEmissionKind(),  // DebugEmissionKind
-      0                        // DWOId
-  );
+      0,                       // DWOId
+      true,                    // SplitDebugInlining
+      opts::fDebugInfoForProfiling);
 }
 
 DIModule DIBuilder::EmitModule(Module *m) {
@@ -131,6 +131,7 @@ DRValue *DLValue::getRVal() {
   }
 
   LLValue *rval = DtoLoad(DtoMemType(type), val);
+  DtoApplyTBAA(llvm::cast<llvm::LoadInst>(rval), type, val);
 
   const auto ty = type->toBasetype()->ty;
   if (ty == TY::Tbool) {
@@ -19,6 +19,7 @@
 #include "gen/trycatchfinally.h"
 #include "gen/variable_lifetime.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include <vector>
 
 class Identifier;
@@ -200,6 +201,11 @@ public:
   /// value.
   llvm::AllocaInst *retValSlot = nullptr;
 
+  /// Pointers to overlapping (union) fields, with -fstrict-aliasing. Accesses
+  /// through these get no TBAA tags, as D allows type punning via unions, see
+  /// DtoFinalizeTBAA() for other uses.
+  llvm::DenseSet<llvm::Value *> unionFieldPointers;
+
   /// Emits a call or invoke to the given callee, depending on whether there
   /// are catches/cleanups active or not.
   llvm::CallBase *callOrInvoke(llvm::Value *callee,
@@ -19,57 +19,104 @@
 #include "dmd/template.h"
 #include "gen/irstate.h"
 #include "gen/logger.h"
+#include "gen/mangling.h"
 #include "gen/optimizer.h"
+#include "gen/pgo_ASTbased.h"
 #include "gen/recursivevisitor.h"
 #include "gen/uda.h"
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
 
 using namespace dmd;
 
+namespace cl = llvm::cl;
+
+static cl::opt<unsigned> crossModuleInlineThreshold(
+    "cross-module-inline-threshold", cl::ZeroOrMore, cl::Hidden,
+    cl::init(60),
+    cl::desc("Maximum estimated cost of functions from other modules to be "
+             "made available for inlining"));
+
+static cl::opt<unsigned> crossModuleInlineHotThreshold(
+    "cross-module-inline-hot-threshold", cl::ZeroOrMore, cl::Hidden,
+    cl::init(240),
+    cl::desc("Maximum estimated cost of functions from other modules to be "
+             "made available for inlining if they are hot according to the "
+             "PGO profile"));
+
 namespace {
 
-/// An ASTVisitor that checks whether the number of statements is larger than a
-/// certain number.
-struct MoreThanXStatements : public StoppableVisitor {
-  /// Are there more or fewer statements than `threshold`?.
-  unsigned threshold;
-  /// The statement count.
-  unsigned count;
+/// A cheap summary of a function body, used to estimate the cost of making
+/// the function available for inlining in other modules.
+struct InlineSummary {
+  /// Number of statements and non-trivial expressions, a rough estimate of
+  /// the IR size.
+  unsigned size = 0;
+  /// Number of calls (incl. `new` expressions).
+  unsigned calls = 0;
+  /// Number of loops.
+  unsigned loops = 0;
+
+  /// Calls are weighed more, as the arguments need to be set up and the
+  /// callees may in turn be inlined. Loops are weighed more as they are
+  /// likely to be unrolled and/or vectorized, and their iterations dwarf the
+  /// call overhead anyway.
+  unsigned cost() const { return size + 5 * calls + 10 * loops; }
+};
+
+/// An ASTVisitor that computes the InlineSummary of a function body, stopping
+/// once the cost exceeds a certain limit.
+struct InlineSummaryVisitor : public StoppableVisitor {
+  InlineSummary summary;
+  unsigned limit;
 
-  explicit MoreThanXStatements(unsigned X) : threshold(X), count(0) {}
+  explicit InlineSummaryVisitor(unsigned limit) : limit(limit) {}
 
   using StoppableVisitor::visit;
 
-  void visit(Statement *stmt) override {
-    count++;
-    if (count > threshold)
+  void add(unsigned &counter) {
+    counter++;
+    if (summary.cost() > limit)
       stop = true;
   }
-  void visit(Expression *exp) override {}
-  void visit(Declaration *decl) override {}
-  void visit(Initializer *init) override {}
+
+  void visit(Statement *) override { add(summary.size); }
+  // no code for themselves
+  void visit(CompoundStatement *) override {}
+  void visit(ScopeStatement *) override {}
+
+  void visit(WhileStatement *) override { add(summary.loops); }
+  void visit(DoStatement *) override { add(summary.loops); }
+  void visit(ForStatement *) override { add(summary.loops); }
+  void visit(ForeachStatement *) override { add(summary.loops); }
+  void visit(ForeachRangeStatement *) override { add(summary.loops); }
+
+  void visit(Expression *) override { add(summary.size); }
+  // operands, free by themselves
+  void visit(IdentifierExp *) override {}
+  void visit(VarExp *) override {}
+  void visit(ThisExp *) override {}
+  void visit(IntegerExp *) override {}
+  void visit(RealExp *) override {}
+  void visit(NullExp *) override {}
+  void visit(StringExp *) override {}
+
+  void visit(CallExp *) override { add(summary.calls); }
+  void visit(NewExp *) override { add(summary.calls); }
+
+  void visit(Declaration *) override {}
+  void visit(Initializer *) override {}
   void visit(Dsymbol *) override {}
 };
 
-// Use a heuristic to determine if it could make sense to inline this fdecl.
-// Note: isInlineCandidate is called _before_ semantic3 analysis of fdecl.
-bool isInlineCandidate(FuncDeclaration &fdecl) {
-  // Giving maximum inlining potential to LLVM should be possible, but we
-  // restrict it to save some compile time.
-  // return true;
-
-  // TODO: make the heuristic more sophisticated?
-  // In the end, LLVM will make the decision whether to _actually_ inline.
-  // The statement count threshold is completely arbitrary. Also, all
-  // statements are weighed the same.
-
-  unsigned statementThreshold = 10;
-  MoreThanXStatements statementCounter(statementThreshold);
-  RecursiveWalker walker(&statementCounter, false);
+// Summarizes the body of fdecl, up to a cost of `limit`.
+// Note: this is done _before_ semantic3 analysis of fdecl, to save the
+// analysis of functions which aren't going to be inlined anyway.
+InlineSummary summarize(FuncDeclaration &fdecl, unsigned limit) {
+  InlineSummaryVisitor visitor(limit);
+  RecursiveWalker walker(&visitor, false);
   fdecl.fbody->accept(&walker);
-
-  IF_LOG Logger::println("Contains %u statements or more (threshold = %u).",
-                         statementCounter.count, statementThreshold);
-  return statementCounter.count <= statementThreshold;
+  return visitor.summary;
 }
 
 } // end anonymous namespace
@@ -153,8 +200,36 @@ bool defineAsExternallyAvailable(FuncDeclaration &fdecl) {
     return false;
   }
 
-  if (fdecl.inlining != PINLINE::always && !isInlineCandidate(fdecl))
+  // Inlining the default version would bypass the dispatcher, which is only
+  // emitted by the defining module.
+  if (hasTargetClonesUDA(&fdecl)) {
+    IF_LOG Logger::println("@target_clones functions cannot be inlined.");
     return false;
+  }
+
+  // Use a heuristic to determine if it could make sense to inline fdecl; in
+  // the end, LLVM will make the decision whether to _actually_ inline.
+  // Functions exceeding the regular threshold may still be worth it if they
+  // are hot, which can only be checked after semantic analysis.
+  const bool checkCost = fdecl.inlining != PINLINE::always;
+  const bool haveProfile = gIR->getPGOReader() != nullptr;
+  bool needsToBeHot = false;
+  if (checkCost) {
+    const unsigned threshold = crossModuleInlineThreshold;
+    const unsigned hotThreshold =
+        std::max(threshold, crossModuleInlineHotThreshold.getValue());
+    const auto summary =
+        summarize(fdecl, haveProfile ? hotThreshold : threshold);
+    IF_LOG Logger::println("Estimated cost: %u (size: %u, calls: %u, loops: "
+                           "%u) (threshold = %u, hot threshold = %u)",
+                           summary.cost(), summary.size, summary.calls,
+                           summary.loops, threshold, hotThreshold);
+    if (summary.cost() > (haveProfile ? hotThreshold : threshold)) {
+      IF_LOG Logger::println("Too costly for inlining.");
+      return false;
+    }
+    needsToBeHot = summary.cost() > threshold;
+  }
 
   IF_LOG Logger::println("Potential inlining candidate");
 
@@ -190,6 +265,23 @@ bool defineAsExternallyAvailable(FuncDeclaration &fdecl) {
     return false;
   }
 
+  if (checkCost && haveProfile) {
+    const auto entryCount = CodeGenPGO::getExternalEntryCount(
+        &fdecl, getIRMangledName(&fdecl, fdecl.resolvedLinkage()));
+    if (entryCount) {
+      IF_LOG Logger::println("Profiled entry count: %llu",
+                             static_cast<unsigned long long>(*entryCount));
+    }
+    if (entryCount && *entryCount == 0) {
+      IF_LOG Logger::println("Never called according to the profile.");
+      return false;
+    }
+    if (needsToBeHot && !(entryCount && CodeGenPGO::isHotCount(*entryCount))) {
+      IF_LOG Logger::println("Not hot enough for its cost.");
+      return false;
+    }
+  }
+
   IF_LOG Logger::println("defineAsExternallyAvailable? Yes.");
   return true;
 }
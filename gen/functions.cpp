@@ -1342,6 +1342,9 @@ void DtoDefineFunction(FuncDeclaration *fd, bool linkageAvailableExternally) {
     allocaPoint = nullptr;
   }
 
+  DtoFinalizeTBAA(func);
+  funcGen.pgo.emitSampling(func);
+
   if (gIR->dcomputetarget && hasKernelAttr(fd)) {
     auto fn = gIR->module.getFunction(fd->mangleString);
     gIR->dcomputetarget->addKernelMetadata(fd, fn);
@@ -20,6 +20,7 @@
 #include "ir/iraggr.h"
 #include "ir/irvar.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include <deque>
@@ -220,6 +221,10 @@ public:
   // eliminated.
   std::vector<LLConstant *> usedArray;
 
+  // Functions with @ldc.attributes.target_clones and their non-default
+  // targets, see gen/multiversioning.h.
+  llvm::MapVector<llvm::Function *, std::vector<std::string>> targetClones;
+
   /// Whether to emit array bounds checking in the current function.
   bool emitArrayBoundsChecks();
 
@@ -17,6 +17,7 @@
 #include "dmd/init.h"
 #include "dmd/module.h"
 #include "dmd/template.h"
+#include "driver/cl_options.h"
 #include "gen/abi/abi.h"
 #include "gen/arrays.h"
 #include "gen/classes.h"
@@ -447,7 +448,7 @@ void DtoAssign(Loc loc, DValue *lhs, DValue *rhs, EXP op,
       assert(r->getType() == lit);
 #endif
     }
-    gIR->ir->CreateStore(r, l);
+    DtoApplyTBAA(gIR->ir->CreateStore(r, l), lhs->type, l);
   }
 }
 
@@ -1711,6 +1712,19 @@ bool dllimportDataSymbol(Dsymbol *sym) {
   return false;
 }
 
+llvm::GlobalVariable::ThreadLocalMode getThreadLocalMode() {
+  const auto arch = global.params.targetTriple->getArch();
+  if (arch == llvm::Triple::wasm32 || arch == llvm::Triple::wasm64 ||
+      arch == llvm::Triple::avr)
+    return llvm::GlobalVariable::NotThreadLocal;
+
+  // Use a command line option for the thread model.
+  // On PPC there is only local-exec available - in this case just ignore the
+  // command line.
+  return arch == llvm::Triple::ppc ? llvm::GlobalVariable::LocalExecTLSModel
+                                   : clThreadModel.getValue();
+}
+
 llvm::GlobalVariable *declareGlobal(Loc loc, llvm::Module &module,
                                     llvm::Type *type,
                                     llvm::StringRef mangledName,
@@ -1748,14 +1762,8 @@ llvm::GlobalVariable *declareGlobal(Loc loc, llvm::Module &module,
     return existing;
   }
 
-  // Use a command line option for the thread model.
-  // On PPC there is only local-exec available - in this case just ignore the
-  // command line.
-  const auto tlsModel =
-      isThreadLocal
-          ? (arch == llvm::Triple::ppc ? llvm::GlobalVariable::LocalExecTLSModel
-                                       : clThreadModel.getValue())
-          : llvm::GlobalVariable::NotThreadLocal;
+  const auto tlsModel = isThreadLocal ? getThreadLocalMode()
+                                      : llvm::GlobalVariable::NotThreadLocal;
 
   auto gvar = new llvm::GlobalVariable(module, type, isConstant,
                                        llvm::GlobalValue::ExternalLinkage,
@@ -1879,6 +1887,12 @@ DLValue *DtoIndexAggregate(LLValue *src, AggregateDeclaration *ad,
     }
   }
 
+  if (opts::fStrictAliasing && !gIR->funcGenStates.empty()) {
+    auto &unionFieldPointers = gIR->funcGen().unionFieldPointers;
+    if (vd->overlapped() || unionFieldPointers.count(src))
+      unionFieldPointers.insert(ptr);
+  }
+
   IF_LOG Logger::cout() << "Pointer: " << *ptr << '\n';
   if (auto p = isaPointer(ty)) {
     if (p->getAddressSpace())
@@ -240,6 +240,10 @@ bool defineOnDeclare(Dsymbol *sym, bool isFunction);
 /// Indicates whether the specified data symbol is to be declared as dllimport.
 bool dllimportDataSymbol(Dsymbol *sym);
 
+/// Returns the TLS model for thread-locals (-fthread-model), NotThreadLocal for
+/// targets without TLS support.
+llvm::GlobalVariable::ThreadLocalMode getThreadLocalMode();
+
 /// Tries to declare an LLVM global. If a variable with the same mangled name
 /// already exists, checks if the types match and returns it instead.
 ///
@@ -0,0 +1,266 @@
+//===-- multiversioning.cpp -----------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/multiversioning.h"
+
+#include "dmd/errors.h"
+#include "dmd/globals.h"
+#include "gen/irstate.h"
+#include "gen/llvm.h"
+#include "gen/logger.h"
+#include "gen/runtime.h"
+#include "gen/tollvm.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+
+using namespace dmd;
+
+namespace {
+
+/// The CPU features a version can be selected for, with their bit in the mask
+/// returned by druntime's `_d_cpu_features()` (rt.cpufeatures.CpuFeature).
+/// The names are the LLVM feature names.
+const struct {
+  const char *name;
+  uint32_t bit;
+} cpuFeatures[] = {
+    {"sse3", 1u << 0},      {"ssse3", 1u << 1},     {"sse4.1", 1u << 2},
+    {"sse4.2", 1u << 3},    {"popcnt", 1u << 4},    {"aes", 1u << 5},
+    {"pclmul", 1u << 6},    {"avx", 1u << 7},       {"fma", 1u << 8},
+    {"f16c", 1u << 9},      {"avx2", 1u << 10},     {"bmi", 1u << 11},
+    {"bmi2", 1u << 12},     {"avx512f", 1u << 13},  {"avx512dq", 1u << 14},
+    {"avx512cd", 1u << 15}, {"avx512bw", 1u << 16}, {"avx512vl", 1u << 17},
+    {"avx512vnni", 1u << 18},
+};
+
+void splitFeatures(llvm::StringRef target,
+                   llvm::SmallVectorImpl<llvm::StringRef> &features) {
+  target.split(features, ',', -1, false);
+  for (auto &f : features)
+    f = f.trim();
+}
+
+/// Returns the feature mask for a target like "avx2,fma", or 0 if it contains
+/// an unknown feature (returned in `unknown`).
+uint32_t getFeatureMask(llvm::StringRef target, llvm::StringRef &unknown) {
+  llvm::SmallVector<llvm::StringRef, 4> features;
+  splitFeatures(target, features);
+
+  uint32_t mask = 0;
+  for (auto f : features) {
+    auto it = llvm::find_if(cpuFeatures, [f](const auto &cf) {
+      return f == cf.name;
+    });
+    if (it == std::end(cpuFeatures)) {
+      unknown = f;
+      return 0;
+    }
+    mask |= it->bit;
+  }
+  return mask;
+}
+
+llvm::Function *cloneForTarget(llvm::Function *func, const std::string &name,
+                               llvm::StringRef target) {
+  llvm::ValueToValueMapTy VMap;
+  llvm::Function *clone = llvm::CloneFunction(func, VMap);
+
+  std::string suffix = target.str();
+  std::replace(suffix.begin(), suffix.end(), ',', '_');
+  clone->setName(name + "." + suffix);
+  clone->setComdat(func->getComdat());
+
+  // Append the features to the command-line ones, like @target does.
+  std::string features;
+  if (func->hasFnAttribute("target-features")) {
+    features =
+        func->getFnAttribute("target-features").getValueAsString().str();
+  }
+  llvm::SmallVector<llvm::StringRef, 4> fragments;
+  splitFeatures(target, fragments);
+  for (auto f : fragments) {
+    if (!features.empty())
+      features += ',';
+    features += ("+" + f).str();
+  }
+  clone->addFnAttr("target-features", features);
+
+  return clone;
+}
+
+void emitDispatch(IRState &irs, llvm::Function *func,
+                  const std::vector<std::string> &targets) {
+  auto &module = irs.module;
+  auto &context = irs.context();
+  LLPointerType *ptrTy = getOpaquePtrType();
+
+  const std::string name = func->getName().str();
+  IF_LOG Logger::println("Emitting target clones of %s", name.c_str());
+  LOG_SCOPE;
+
+  // The function becomes the default version.
+  const auto linkage = func->getLinkage();
+  func->setName(name + ".default");
+
+  llvm::SmallVector<std::pair<llvm::Function *, uint32_t>, 4> versions;
+  for (const auto &target : targets) {
+    llvm::StringRef unknown;
+    versions.emplace_back(cloneForTarget(func, name, target),
+                          getFeatureMask(target, unknown));
+  }
+
+  auto resolver = llvm::Function::Create(
+      llvm::FunctionType::get(ptrTy, false), llvm::GlobalValue::InternalLinkage,
+      name + ".resolver", &module);
+  resolver->setComdat(func->getComdat());
+  resolver->addFnAttr(llvm::Attribute::NoUnwind);
+
+  // Replace the function by the dispatcher, for callers and for function
+  // pointers alike.
+  const bool useIFunc = global.params.targetTriple->isOSBinFormatELF();
+  llvm::GlobalObject *dispatcher;
+  llvm::Function *thunk = nullptr;
+  if (useIFunc) {
+    auto ifunc =
+        llvm::GlobalIFunc::create(func->getFunctionType(),
+                                  func->getAddressSpace(), linkage, name,
+                                  resolver, &module);
+    ifunc->setVisibility(func->getVisibility());
+    dispatcher = ifunc;
+  } else {
+    thunk = llvm::Function::Create(func->getFunctionType(), linkage, name,
+                                   &module);
+    thunk->copyAttributesFrom(func);
+    dispatcher = thunk;
+  }
+  dispatcher->setComdat(func->getComdat());
+  func->replaceAllUsesWith(dispatcher);
+
+  const auto makeInternal = [](llvm::Function *f) {
+    f->setLinkage(llvm::GlobalValue::InternalLinkage);
+    f->setVisibility(llvm::GlobalValue::DefaultVisibility);
+    f->setDLLStorageClass(llvm::GlobalValue::DefaultStorageClass);
+  };
+  makeInternal(func);
+  for (const auto &v : versions)
+    makeInternal(v.first);
+
+  // The resolver selects the last version whose features are all supported.
+  {
+    llvm::IRBuilder<> b(llvm::BasicBlock::Create(context, "", resolver));
+    llvm::Value *supported =
+        b.CreateCall(getRuntimeFunction(Loc(), module, "_d_cpu_features"));
+    llvm::Value *selected = func;
+    for (const auto &v : versions) {
+      llvm::Value *mask = b.getInt32(v.second);
+      selected = b.CreateSelect(
+          b.CreateICmpEQ(b.CreateAnd(supported, mask), mask), v.first,
+          selected);
+    }
+    b.CreateRet(selected);
+  }
+
+  if (useIFunc)
+    return;
+
+  // Without ifuncs, a module constructor stores the selected version in a
+  // function pointer, which the thunk tail-calls.
+  auto fnPtr =
+      new llvm::GlobalVariable(module, ptrTy, false,
+                               llvm::GlobalValue::InternalLinkage, func,
+                               name + ".ptr");
+
+  {
+    llvm::IRBuilder<> b(llvm::BasicBlock::Create(context, "", thunk));
+    llvm::SmallVector<llvm::Value *, 8> args;
+    for (auto &arg : thunk->args())
+      args.push_back(&arg);
+    auto callee = b.CreateLoad(ptrTy, fnPtr);
+    auto call = b.CreateCall(func->getFunctionType(), callee, args);
+    call->setCallingConv(func->getCallingConv());
+    call->setAttributes(func->getAttributes());
+    call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    if (call->getType()->isVoidTy()) {
+      b.CreateRetVoid();
+    } else {
+      b.CreateRet(call);
+    }
+  }
+
+  auto ctor = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+      llvm::GlobalValue::InternalLinkage, name + ".init", &module);
+  ctor->addFnAttr(llvm::Attribute::NoUnwind);
+  {
+    llvm::IRBuilder<> b(llvm::BasicBlock::Create(context, "", ctor));
+    b.CreateStore(b.CreateCall(resolver), fnPtr);
+    b.CreateRetVoid();
+  }
+  llvm::appendToGlobalCtors(module, ctor, 0);
+}
+
+} // anonymous namespace
+
+void registerTargetClones(IRState &irs, const Loc &loc, llvm::Function *func,
+                          llvm::ArrayRef<llvm::StringRef> targets) {
+  if (!global.params.targetTriple->isX86()) {
+    error(loc, "`@ldc.attributes.target_clones` is only supported for x86 "
+               "targets");
+    return;
+  }
+  if (func->isVarArg()) {
+    error(loc, "`@ldc.attributes.target_clones` is not supported for "
+               "C-style variadic functions");
+    return;
+  }
+
+  bool ok = true;
+  bool hasDefault = false;
+  std::vector<std::string> clones;
+  for (auto target : targets) {
+    target = target.trim();
+    if (target == "default") {
+      hasDefault = true;
+      continue;
+    }
+
+    llvm::StringRef unknown;
+    if (target.empty()) {
+      error(loc, "empty target in `@ldc.attributes.target_clones`");
+      ok = false;
+    } else if (!getFeatureMask(target, unknown)) {
+      error(loc,
+            "unknown CPU feature `%.*s` in `@ldc.attributes.target_clones`",
+            static_cast<int>(unknown.size()), unknown.data());
+      ok = false;
+    } else if (!llvm::is_contained(clones, target)) {
+      clones.push_back(target.str());
+    }
+  }
+
+  if (!hasDefault) {
+    error(loc, "`@ldc.attributes.target_clones` requires a `\"default\"` "
+               "target");
+    ok = false;
+  }
+
+  if (ok)
+    irs.targetClones[func] = std::move(clones);
+}
+
+void emitTargetClones(IRState &irs) {
+  for (const auto &entry : irs.targetClones) {
+    // only the module defining the function emits the versions
+    llvm::Function *func = entry.first;
+    if (!func->isDeclaration() && !func->hasAvailableExternallyLinkage())
+      emitDispatch(irs, func, entry.second);
+  }
+  irs.targetClones.clear();
+}
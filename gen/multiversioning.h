@@ -0,0 +1,37 @@
+//===-- gen/multiversioning.h - Function multiversioning --------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Support for @ldc.attributes.target_clones: functions compiled for multiple
+// targets, with the version to run selected based on the CPU features at run
+// time.
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace llvm {
+class Function;
+}
+
+struct IRState;
+struct Loc;
+
+/// Checks the targets of a function with @target_clones and records them for
+/// emitTargetClones().
+void registerTargetClones(IRState &irs, const Loc &loc, llvm::Function *func,
+                          llvm::ArrayRef<llvm::StringRef> targets);
+
+/// Emits the versions of all registered functions defined in the module, and
+/// replaces each function by a dispatcher (an ifunc for ELF targets, a thunk
+/// calling through a function pointer initialized by a module constructor
+/// otherwise).
+void emitTargetClones(IRState &irs);
@@ -21,8 +21,10 @@
 #ifndef IN_JITRT
 #include "dmd/errors.h"
 #include "gen/logger.h"
+#include "gen/pgo_sample.h"
 #endif
 
+#include "gen/passes/BoundsCheckElimination.h"
 #include "gen/passes/GarbageCollect2Stack.h"
 #include "gen/passes/StripExternals.h"
 #include "gen/passes/SimplifyDRuntimeCalls.h"
@@ -51,6 +53,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/LinkAllPasses.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Target/TargetMachine.h"
 #if LDC_LLVM_VER >= 2000
 #include "llvm/Transforms/Utils/Instrumentation.h"
@@ -115,6 +118,10 @@ static cl::opt<bool> disableGCToStack(
     "disable-gc2stack", cl::ZeroOrMore,
     cl::desc("Disable promotion of GC allocations to stack memory"));
 
+static cl::opt<bool> disableBoundsCheckElim(
+    "disable-boundscheck-elim", cl::ZeroOrMore,
+    cl::desc("Disable removal and hoisting of array bounds checks"));
+
 #ifndef IN_JITRT
 static cl::opt<cl::boolOrDefault, false, opts::FlagParser<cl::boolOrDefault>>
     enableInlining(
@@ -355,10 +362,28 @@ static void addGarbageCollect2StackPass(ModulePassManager &mpm,
   }
 }
 
+static void addBoundsCheckEliminationPass(FunctionPassManager &fpm,
+                                          OptimizationLevel level) {
+  if (level == OptimizationLevel::O2 || level == OptimizationLevel::O3) {
+    fpm.addPass(BoundsCheckEliminationPass());
+    if (verifyEach) {
+      fpm.addPass(VerifierPass());
+    }
+  }
+}
+
 #ifndef IN_JITRT
-static llvm::Optional<PGOOptions> getPGOOptions() {
-  // FIXME: Do we have these anywhere?
-  bool debugInfoForProfiling = false;
+static cl::opt<bool> sampleProfileMatchDNames(
+    "sample-profile-match-d-names", cl::ZeroOrMore, cl::Hidden,
+    cl::desc("Match sample profile entries to functions by their D names "
+             "without unstable parts (e.g., lambda numbering)"),
+    cl::init(true));
+
+/// `sampleProfile` overrides the path of the sample profile to use.
+static llvm::Optional<PGOOptions>
+getPGOOptions(const std::string &sampleProfile) {
+  const bool debugInfoForProfiling = opts::fDebugInfoForProfiling;
+  // FIXME: Do we have this anywhere?
   bool pseudoProbeForProfiling = false;
   if (opts::isInstrumentingForIRBasedPGO()) {
     return PGOOptions(
@@ -384,7 +409,9 @@ static llvm::Optional<PGOOptions> getPGOOptions() {
         debugInfoForProfiling, pseudoProbeForProfiling);
   } else if (opts::isUsingSampleBasedPGOProfile()) {
     return PGOOptions(
-        global.params.datafileInstrProf, "", "",
+        sampleProfile.empty() ? global.params.datafileInstrProf
+                              : sampleProfile.c_str(),
+        "", "",
 #if LDC_LLVM_VER >= 1700
         "" /*MemoryProfileUsePath*/, llvm::vfs::getRealFileSystem(),
 #endif
@@ -393,6 +420,18 @@ static llvm::Optional<PGOOptions> getPGOOptions() {
         PGOOptions::ColdFuncOpt::Default,
 #endif
         debugInfoForProfiling, pseudoProbeForProfiling);
+  } else if (debugInfoForProfiling) {
+    // e.g., when building the binary to collect a sample profile for
+    return PGOOptions("", "", "",
+#if LDC_LLVM_VER >= 1700
+                      "" /*MemoryProfileUsePath*/, nullptr,
+#endif
+                      PGOOptions::PGOAction::NoAction,
+                      PGOOptions::CSPGOAction::NoCSAction,
+#if LDC_LLVM_VER >= 1900
+                      PGOOptions::ColdFuncOpt::Default,
+#endif
+                      debugInfoForProfiling);
   }
 #if LDC_LLVM_VER < 1600
   return None;
@@ -475,11 +514,22 @@ void runOptimizationPasses(llvm::Module *M, llvm::TargetMachine *TM) {
   si.registerCallbacks(pic, &mam);
 #endif
 
+#ifndef IN_JITRT
+  // Match the sample profile to renamed functions via a remapped copy.
+  std::string sampleProfile;
+  llvm::FileRemover sampleProfileRemover;
+  if (opts::isUsingSampleBasedPGOProfile() && sampleProfileMatchDNames) {
+    sampleProfile = remapSampleProfile(*M, global.params.datafileInstrProf);
+    if (!sampleProfile.empty())
+      sampleProfileRemover.setFile(sampleProfile);
+  }
+#endif
+
   PassBuilder pb(TM, getPipelineTuningOptions(optLevelVal, sizeLevelVal),
 #ifdef IN_JITRT
                  {}, &pic);
 #else
-                 getPGOOptions(), &pic);
+                 getPGOOptions(sampleProfile), &pic);
 #endif
 
   // register the target library analysis directly because clang does :)
@@ -538,6 +588,10 @@ void runOptimizationPasses(llvm::Module *M, llvm::TargetMachine *TM) {
       //(had registerLoopOptimizerEndEPCallback) but that seems wrong
       pb.registerOptimizerLastEPCallback(addGarbageCollect2StackPass);
     }
+    if (!disableBoundsCheckElim) {
+      // Before the loop vectorizer, which benefits from check-free loops.
+      pb.registerVectorizerStartEPCallback(addBoundsCheckEliminationPass);
+    }
   }
 
   pb.registerOptimizerLastEPCallback(addStripExternalsPass);
@@ -664,6 +718,7 @@ void outputOptimizationSettings(llvm::raw_ostream &hash_os) {
   hash_os << disableSimplifyDruntimeCalls;
   hash_os << disableSimplifyLibCalls;
   hash_os << disableGCToStack;
+  hash_os << disableBoundsCheckElim;
   hash_os << stripDebug;
   hash_os << disableLoopUnrolling;
   hash_os << disableLoopVectorization;
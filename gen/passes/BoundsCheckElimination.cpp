@@ -0,0 +1,414 @@
+//===-- BoundsCheckElimination.cpp - Remove and hoist array bounds checks -===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Array bounds checks are emitted as conditional branches tagged with
+// LDC_BOUNDSCHECK_MD metadata, either to the block continuing normally or to
+// a block calling the druntime range error handler. The passing condition is
+// a conjunction of integer comparisons (an index against the length, or the
+// bounds of a slice).
+//
+// This pass
+//  1. removes the comparisons ScalarEvolution proves to hold at the check,
+//     e.g., due to a dominating check on the same slice or a loop guard, and
+//  2. versions innermost loops whose checks compare affine induction
+//     variables (with unit stride) to loop-invariant values: a single check in
+//     the preheader, covering the whole induction range, selects a copy of the
+//     loop without these checks. Otherwise the original loop runs with all
+//     checks, so that the range error is still raised in the same iteration
+//     and with the same values.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/passes/BoundsCheckElimination.h"
+#include "metadata.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/DomTreeUpdater.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/PatternMatch.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/Local.h"
+#include "llvm/Transforms/Utils/LoopSimplify.h"
+#include "llvm/Transforms/Utils/LoopUtils.h"
+#include "llvm/Transforms/Utils/ScalarEvolutionExpander.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+#define DEBUG_TYPE "dboundscheckelim"
+
+using namespace llvm;
+using namespace llvm::PatternMatch;
+
+STATISTIC(NumRemoved, "Number of bounds check comparisons proven redundant");
+STATISTIC(NumHoisted,
+          "Number of bounds check comparisons hoisted out of loops");
+STATISTIC(NumVersioned, "Number of loops versioned to hoist bounds checks");
+
+static cl::opt<unsigned> MaxLoopSize(
+    "dboundscheckelim-max-loop-size", cl::ZeroOrMore, cl::Hidden,
+    cl::init(500),
+    cl::desc("Don't version loops with more instructions than this"));
+
+namespace {
+/// A comparison which must hold for a bounds check to pass.
+struct Atom {
+  ICmpInst *Cmp;
+  /// The predicate for passing, the inverse of Cmp's if the branch is
+  /// inverted.
+  ICmpInst::Predicate Pred;
+};
+
+struct BoundsCheck {
+  BranchInst *Br;
+  /// The successor taken if the check passes.
+  unsigned OkIdx;
+  SmallVector<Atom, 2> Atoms;
+};
+
+/// A condition to be checked before the loop.
+struct PreCond {
+  ICmpInst::Predicate Pred;
+  const SCEV *LHS, *RHS;
+};
+
+/// The range [Lo, Hi] of values an expression takes in a loop. Unless
+/// invariant, the range is only valid if Lo <=u Hi.
+struct Range {
+  const SCEV *Lo, *Hi;
+  bool Invariant;
+};
+
+bool isFailBlock(BasicBlock *BB) {
+  auto term = BB->getTerminator();
+  if (isa<UnreachableInst>(term))
+    return true;
+  // the error handler is invoked inside try blocks
+  if (auto invoke = dyn_cast<InvokeInst>(term))
+    return isa<UnreachableInst>(invoke->getNormalDest()->getFirstNonPHI());
+  return false;
+}
+
+// Collects the comparisons of an and-tree (or-tree if inverted).
+bool collectAtoms(Value *V, bool inverted, SmallVectorImpl<Atom> &atoms) {
+  Value *A, *B;
+  if (inverted ? match(V, m_LogicalOr(m_Value(A), m_Value(B)))
+               : match(V, m_LogicalAnd(m_Value(A), m_Value(B)))) {
+    return collectAtoms(A, inverted, atoms) &&
+           collectAtoms(B, inverted, atoms);
+  }
+
+  auto cmp = dyn_cast<ICmpInst>(V);
+  if (!cmp || !cmp->getOperand(0)->getType()->isIntegerTy())
+    return false;
+  atoms.push_back(
+      {cmp, inverted ? cmp->getInversePredicate() : cmp->getPredicate()});
+  return true;
+}
+
+bool getBoundsCheck(Instruction *term, unsigned mdKind, BoundsCheck &check) {
+  auto br = dyn_cast_or_null<BranchInst>(term);
+  if (!br || !br->isConditional() || !br->getMetadata(mdKind))
+    return false;
+
+  // InstCombine may have inverted the condition and swapped the successors.
+  const bool fail0 = isFailBlock(br->getSuccessor(0));
+  const bool fail1 = isFailBlock(br->getSuccessor(1));
+  if (fail0 == fail1)
+    return false;
+
+  check.Br = br;
+  check.OkIdx = fail1 ? 0 : 1;
+  check.Atoms.clear();
+  return collectAtoms(br->getCondition(), check.OkIdx == 1, check.Atoms);
+}
+
+// Removes the atoms flagged in `drop` from a check, making the branch
+// unconditional if none are left. The removed edge is reported to `DTU`, if
+// given.
+void removeAtoms(const BoundsCheck &check, ArrayRef<bool> drop,
+                 DomTreeUpdater *DTU = nullptr) {
+  BranchInst *br = check.Br;
+  Value *oldCond = br->getCondition();
+
+  Value *newCond = nullptr;
+  IRBuilder<> builder(br);
+  for (size_t i = 0; i < check.Atoms.size(); ++i) {
+    if (drop[i])
+      continue;
+    Value *cmp = check.Atoms[i].Cmp;
+    if (!newCond) {
+      newCond = cmp;
+    } else if (check.OkIdx == 0) {
+      newCond = builder.CreateAnd(newCond, cmp);
+    } else {
+      newCond = builder.CreateOr(newCond, cmp);
+    }
+  }
+
+  if (newCond) {
+    br->setCondition(newCond);
+  } else {
+    BasicBlock *BB = br->getParent();
+    BasicBlock *failBB = br->getSuccessor(1 - check.OkIdx);
+    failBB->removePredecessor(BB);
+    BranchInst::Create(br->getSuccessor(check.OkIdx), br);
+    br->eraseFromParent();
+    if (DTU)
+      DTU->applyUpdates({{DominatorTree::Delete, BB, failBB}});
+  }
+
+  RecursivelyDeleteTriviallyDeadInstructions(oldCond);
+}
+
+bool removeRedundantChecks(Function &F, ScalarEvolution &SE,
+                           unsigned mdKind) {
+  // Decide first, then transform, so that the analyses stay valid.
+  SmallVector<std::pair<BoundsCheck, SmallVector<bool, 2>>, 16> redundant;
+  for (auto &BB : F) {
+    BoundsCheck check;
+    if (!getBoundsCheck(BB.getTerminator(), mdKind, check))
+      continue;
+
+    SmallVector<bool, 2> known;
+    bool any = false;
+    for (const auto &atom : check.Atoms) {
+      const bool k = SE.isKnownPredicateAt(
+          atom.Pred, SE.getSCEV(atom.Cmp->getOperand(0)),
+          SE.getSCEV(atom.Cmp->getOperand(1)), check.Br);
+      known.push_back(k);
+      any |= k;
+    }
+    if (any)
+      redundant.emplace_back(std::move(check), std::move(known));
+  }
+
+  for (const auto &p : redundant) {
+    LLVM_DEBUG(dbgs() << "Removing redundant bounds check: " << *p.first.Br
+                      << '\n');
+    removeAtoms(p.first, p.second);
+    NumRemoved += count(p.second, true);
+  }
+
+  return !redundant.empty();
+}
+
+bool containsUDiv(const SCEV *S) {
+  return SCEVExprContains(S, [](const SCEV *X) { return isa<SCEVUDivExpr>(X); });
+}
+
+bool getRange(const SCEV *S, const Loop *L, const SCEV *maxBTC,
+              ScalarEvolution &SE, Range &range) {
+  if (SE.isLoopInvariant(S, L)) {
+    range = {S, S, true};
+    return true;
+  }
+
+  auto AR = dyn_cast<SCEVAddRecExpr>(S);
+  if (!AR || AR->getLoop() != L || !AR->isAffine())
+    return false;
+  auto step = dyn_cast<SCEVConstant>(AR->getStepRecurrence(SE));
+  if (!step || SE.getTypeSizeInBits(maxBTC->getType()) >
+                   SE.getTypeSizeInBits(S->getType())) {
+    return false;
+  }
+
+  // The check is executed at most in iterations 0 .. maxBTC.
+  const SCEV *start = AR->getStart();
+  const SCEV *n = SE.getNoopOrZeroExtend(maxBTC, S->getType());
+  if (step->getValue()->isOne()) {
+    range = {start, SE.getAddExpr(start, n), false};
+  } else if (step->getValue()->isMinusOne()) {
+    range = {SE.getMinusSCEV(start, n), start, false};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Determines the conditions under which an atom holds in all iterations.
+bool getPreConds(const Atom &atom, const Loop *L, const SCEV *maxBTC,
+                 ScalarEvolution &SE, SmallVectorImpl<PreCond> &preConds) {
+  ICmpInst::Predicate pred = atom.Pred;
+  const SCEV *lhs = SE.getSCEV(atom.Cmp->getOperand(0));
+  const SCEV *rhs = SE.getSCEV(atom.Cmp->getOperand(1));
+  if (pred == ICmpInst::ICMP_UGT || pred == ICmpInst::ICMP_UGE) {
+    pred = ICmpInst::getSwappedPredicate(pred);
+    std::swap(lhs, rhs);
+  }
+  if (pred != ICmpInst::ICMP_ULT && pred != ICmpInst::ICMP_ULE)
+    return false;
+
+  Range l, r;
+  if (!getRange(lhs, L, maxBTC, SE, l) || !getRange(rhs, L, maxBTC, SE, r))
+    return false;
+  if (l.Invariant && r.Invariant) // not hoisted by LICM for a reason
+    return false;
+
+  for (const SCEV *S : {l.Lo, l.Hi, r.Lo, r.Hi}) {
+    if (containsUDiv(S))
+      return false;
+  }
+
+  if (!l.Invariant)
+    preConds.push_back({ICmpInst::ICMP_ULE, l.Lo, l.Hi});
+  if (!r.Invariant)
+    preConds.push_back({ICmpInst::ICMP_ULE, r.Lo, r.Hi});
+  preConds.push_back({pred, l.Hi, r.Lo});
+  return true;
+}
+
+unsigned getLoopSize(const Loop *L) {
+  unsigned size = 0;
+  for (const BasicBlock *BB : L->blocks())
+    size += BB->size();
+  return size;
+}
+
+// Clones the loop, branching to the original (fast) version if `preCond`
+// holds, and to the clone otherwise. See llvm::LoopVersioning.
+void versionLoop(Loop *L, Value *preCond, unsigned mdKind, DominatorTree &DT,
+                 LoopInfo &LI) {
+  SmallVector<BasicBlock *, 4> exitBlocks;
+  L->getUniqueExitBlocks(exitBlocks);
+
+  BasicBlock *checkBB = L->getLoopPreheader();
+  checkBB->setName(L->getHeader()->getName() + ".bounds.check");
+  BasicBlock *PH = SplitBlock(checkBB, checkBB->getTerminator(), &DT, &LI,
+                              nullptr, L->getHeader()->getName() + ".ph");
+
+  ValueToValueMapTy VMap;
+  SmallVector<BasicBlock *, 8> clonedBlocks;
+  Loop *clone = cloneLoopWithPreheader(PH, checkBB, L, VMap, ".checked", &LI,
+                                       &DT, clonedBlocks);
+  remapInstructionsInBlocks(clonedBlocks, VMap);
+
+  // Don't version the clone again.
+  for (BasicBlock *BB : clone->blocks()) {
+    BB->getTerminator()->setMetadata(mdKind, nullptr);
+  }
+
+  Instruction *term = checkBB->getTerminator();
+  BranchInst::Create(PH, clone->getLoopPreheader(), preCond, term);
+  term->eraseFromParent();
+
+  // The loop is in LCSSA form, so only the PHIs in the exit blocks need to
+  // be extended for the cloned exiting blocks.
+  for (BasicBlock *exit : exitBlocks) {
+    for (PHINode &phi : exit->phis()) {
+      for (unsigned i = 0, e = phi.getNumIncomingValues(); i != e; ++i) {
+        BasicBlock *pred = phi.getIncomingBlock(i);
+        if (!L->contains(pred))
+          continue;
+        Value *v = phi.getIncomingValue(i);
+        Value *mapped = VMap.lookup(v);
+        phi.addIncoming(mapped ? mapped : v, cast<BasicBlock>(VMap[pred]));
+      }
+    }
+  }
+
+  // Blocks dominated by the loop might be reached from the clone too now.
+  DT.recalculate(*checkBB->getParent());
+}
+
+bool hoistLoopChecks(Loop *L, DominatorTree &DT, LoopInfo &LI,
+                     ScalarEvolution &SE, unsigned mdKind) {
+  SmallVector<std::pair<BoundsCheck, SmallVector<bool, 2>>, 8> checks;
+  SmallVector<PreCond, 8> preConds;
+  for (BasicBlock *BB : L->blocks()) {
+    BoundsCheck check;
+    if (!getBoundsCheck(BB->getTerminator(), mdKind, check))
+      continue;
+    checks.emplace_back(std::move(check), SmallVector<bool, 2>());
+  }
+  if (checks.empty() || !L->isSafeToClone() || getLoopSize(L) > MaxLoopSize)
+    return false;
+
+  const SCEV *maxBTC = SE.getSymbolicMaxBackedgeTakenCount(L);
+  if (isa<SCEVCouldNotCompute>(maxBTC) || containsUDiv(maxBTC))
+    return false;
+
+  unsigned numHoisted = 0;
+  for (auto &p : checks) {
+    for (const auto &atom : p.first.Atoms) {
+      const bool hoist = getPreConds(atom, L, maxBTC, SE, preConds);
+      p.second.push_back(hoist);
+      numHoisted += hoist;
+    }
+  }
+  if (!numHoisted)
+    return false;
+
+  if (!L->isLoopSimplifyForm())
+    simplifyLoop(L, &DT, &LI, &SE, nullptr, nullptr, false);
+  if (!L->isLoopSimplifyForm() || !L->getLoopPreheader())
+    return false;
+  formLCSSA(*L, DT, &LI, &SE);
+
+  LLVM_DEBUG(dbgs() << "Versioning loop " << L->getHeader()->getName()
+                    << " for " << numHoisted << " bounds checks\n");
+
+  // Expand the conditions in the preheader.
+  Instruction *insertPt = L->getLoopPreheader()->getTerminator();
+  SCEVExpander expander(SE, insertPt->getModule()->getDataLayout(),
+                        "bounds.pre");
+  IRBuilder<> builder(insertPt);
+  Value *preCond = nullptr;
+  for (const auto &c : preConds) {
+    Value *lhs = expander.expandCodeFor(c.LHS, c.LHS->getType(), insertPt);
+    Value *rhs = expander.expandCodeFor(c.RHS, c.RHS->getType(), insertPt);
+    Value *cmp = builder.CreateICmp(c.Pred, lhs, rhs, "bounds.pre.cmp");
+    preCond = preCond ? builder.CreateAnd(preCond, cmp) : cmp;
+  }
+
+  versionLoop(L, preCond, mdKind, DT, LI);
+
+  // Remove the hoisted comparisons from the original loop, keeping the
+  // dominator tree up-to-date for versioning the remaining loops.
+  DomTreeUpdater DTU(DT, DomTreeUpdater::UpdateStrategy::Eager);
+  for (const auto &p : checks) {
+    if (is_contained(p.second, true))
+      removeAtoms(p.first, p.second, &DTU);
+  }
+
+  SE.forgetLoop(L);
+  ++NumVersioned;
+  NumHoisted += numHoisted;
+  return true;
+}
+} // anonymous namespace
+
+bool BoundsCheckElimination::run(Function &F, DominatorTree &DT, LoopInfo &LI,
+                                 ScalarEvolution &SE) {
+  const unsigned mdKind = F.getContext().getMDKindID(LDC_BOUNDSCHECK_MD);
+
+  bool changed = removeRedundantChecks(F, SE, mdKind);
+  if (changed) {
+    // removing the branches to the failure blocks changes the loop exits
+    DT.recalculate(F);
+    SE.forgetAllLoops();
+  }
+
+  // Loop versioning duplicates code.
+  if (F.hasOptSize())
+    return changed;
+
+  SmallVector<Loop *, 8> loops;
+  for (Loop *L : LI.getLoopsInPreorder()) {
+    if (L->isInnermost())
+      loops.push_back(L);
+  }
+  for (Loop *L : loops)
+    changed |= hoistLoopChecks(L, DT, LI, SE, mdKind);
+
+  return changed;
+}
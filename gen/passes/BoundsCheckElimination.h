@@ -0,0 +1,39 @@
+#pragma once
+#include "gen/passes/Passes.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/PassManager.h"
+
+/// This pass removes array bounds checks (tagged with LDC_BOUNDSCHECK_MD)
+/// which are implied by dominating conditions, and versions innermost loops
+/// so that checks on induction variables are performed once before the loop.
+struct LLVM_LIBRARY_VISIBILITY BoundsCheckElimination {
+  bool run(llvm::Function &F, llvm::DominatorTree &DT, llvm::LoopInfo &LI,
+           llvm::ScalarEvolution &SE);
+
+  static llvm::StringRef getPassName() { return "BoundsCheckElimination"; }
+};
+
+struct LLVM_LIBRARY_VISIBILITY BoundsCheckEliminationPass
+    : public llvm::PassInfoMixin<BoundsCheckEliminationPass> {
+
+  llvm::PreservedAnalyses run(llvm::Function &F,
+                              llvm::FunctionAnalysisManager &fam) {
+    auto &DT = fam.getResult<llvm::DominatorTreeAnalysis>(F);
+    auto &LI = fam.getResult<llvm::LoopAnalysis>(F);
+    auto &SE = fam.getResult<llvm::ScalarEvolutionAnalysis>(F);
+
+    if (pass.run(F, DT, LI, SE)) {
+      return llvm::PreservedAnalyses::none();
+    } else {
+      return llvm::PreservedAnalyses::all();
+    }
+  }
+
+  static llvm::StringRef name() { return BoundsCheckElimination::getPassName(); }
+
+  BoundsCheckEliminationPass() : pass() {}
+private:
+  BoundsCheckElimination pass;
+};
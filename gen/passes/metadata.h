@@ -41,3 +41,8 @@ inline std::string getMetadataName(const char *prefix,
   return (prefix + (globalName[0] == '\1' ? globalName.substr(1) : globalName))
       .str();
 }
+
+// *** Metadata for array bounds checks ***
+// Conditional branches with this (empty) metadata node check array bounds,
+// i.e., one successor raises the range error and doesn't return.
+#define LDC_BOUNDSCHECK_MD "ldc.boundscheck"
@@ -23,15 +23,20 @@
 #include "driver/cl_options_instrumentation.h"
 #include "gen/irstate.h"
 #include "gen/llvm.h"
+#include "gen/llvmhelpers.h"
 #include "gen/logger.h"
 #include "gen/recursivevisitor.h"
 #include "gen/tollvm.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/MDBuilder.h"
 #include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/ProfileData/ProfileCommon.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
 namespace {
 llvm::cl::opt<bool, false, opts::FlagParser<bool>> enablePGOIndirectCalls(
@@ -898,6 +903,14 @@ void CodeGenPGO::applyFunctionAttributes(llvm::Function *Fn) {
 
   uint64_t FunctionCount = getRegionCount(nullptr);
   Fn->setEntryCount(FunctionCount);
+
+  // Keep never executed functions and hot ones apart from the rest, in
+  // .text.unlikely and .text.hot sections (see CodeGenPrepare).
+  if (FunctionCount == 0) {
+    Fn->addFnAttr(llvm::Attribute::Cold);
+  } else if (isHotCount(FunctionCount)) {
+    Fn->addFnAttr(llvm::Attribute::Hot);
+  }
 }
 
 void CodeGenPGO::emitCounterIncrement(const RootObject *S) const {
@@ -915,6 +928,114 @@ void CodeGenPGO::emitCounterIncrement(const RootObject *S) const {
                        gIR->ir->getInt32(counter)});
 }
 
+std::optional<uint64_t>
+CodeGenPGO::getExternalEntryCount(const FuncDeclaration *D,
+                                  llvm::StringRef Name) {
+  llvm::IndexedInstrProfReader *PGOReader = gIR->getPGOReader();
+  if (!PGOReader)
+    return std::nullopt;
+
+  // The function is defined with external linkage in its own module.
+  CodeGenPGO pgo;
+  pgo.emitInstrumentation = false;
+  pgo.setFuncName(Name, llvm::GlobalValue::ExternalLinkage);
+  pgo.mapRegionCounters(D);
+
+  llvm::Expected<llvm::InstrProfRecord> RecordExpected =
+      PGOReader->getInstrProfRecord(pgo.FuncName, pgo.FunctionHash);
+  if (auto EC = RecordExpected.takeError()) {
+    // Missing or stale data isn't worth a warning here, it is reported when
+    // compiling the defining module.
+    llvm::consumeError(std::move(EC));
+    return std::nullopt;
+  }
+  const auto &Counts = RecordExpected->Counts;
+  if (Counts.empty())
+    return std::nullopt;
+  return Counts[0];
+}
+
+bool CodeGenPGO::isHotCount(uint64_t Count) {
+  llvm::IndexedInstrProfReader *PGOReader = gIR->getPGOReader();
+  if (!PGOReader)
+    return false;
+  auto &Summary = PGOReader->getSummary(/*UseCS=*/false);
+  return Count >= llvm::ProfileSummaryBuilder::getHotCountThreshold(
+                      Summary.getDetailedSummary());
+}
+
+namespace {
+/// Returns the per-thread clock counting the invocations of instrumented
+/// functions, for sampling.
+llvm::GlobalVariable *getSamplingClock(llvm::Module &M) {
+  const char *name = "__ldc_profile_sampling_clock";
+  if (auto clock = M.getGlobalVariable(name, /*AllowInternal=*/true))
+    return clock;
+
+  auto int32Ty = llvm::Type::getInt32Ty(M.getContext());
+  auto clock = new llvm::GlobalVariable(
+      M, int32Ty, false, llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantInt::get(int32Ty, 0), name);
+  clock->setThreadLocalMode(getThreadLocalMode());
+  return clock;
+}
+}
+
+// Note that the counts of rarely executed code may be 0 in sampled profiles,
+// which then counts as never executed (see CodeGenPGO::getExternalEntryCount()
+// and applyFunctionAttributes()).
+void CodeGenPGO::emitSampling(llvm::Function *Fn) const {
+  const unsigned period = opts::fProfileInstrSamplingPeriod;
+  if (!opts::isInstrumentingForASTBasedPGO() || !emitInstrumentation ||
+      period == 0)
+    return;
+
+  llvm::SmallVector<llvm::Instruction *, 32> sites;
+  for (auto &BB : *Fn) {
+    for (auto &I : BB) {
+      if (auto II = llvm::dyn_cast<llvm::IntrinsicInst>(&I)) {
+        if (II->getIntrinsicID() == llvm::Intrinsic::instrprof_increment ||
+            II->getIntrinsicID() == llvm::Intrinsic::instrprof_value_profile)
+          sites.push_back(II);
+      }
+    }
+  }
+  if (sites.empty())
+    return;
+
+  // Whether the invocation is sampled is decided once on function entry, so
+  // that the counters of sampled invocations are consistent:
+  //   const sampled = clock < burst;
+  //   clock = (clock + 1 == period ? 0 : clock + 1);
+  // The clock is thread-local, so that the unsampled invocations don't touch
+  // any shared cache lines.
+  llvm::BasicBlock &entry = Fn->getEntryBlock();
+  auto insertPt = entry.getFirstInsertionPt();
+  while (llvm::isa<llvm::AllocaInst>(*insertPt))
+    ++insertPt;
+  llvm::IRBuilder<> b(&entry, insertPt);
+
+  auto clock = getSamplingClock(*Fn->getParent());
+  auto int32Ty = b.getInt32Ty();
+  llvm::Value *current = b.CreateLoad(int32Ty, clock);
+  llvm::Value *next = b.CreateAdd(current, b.getInt32(1));
+  next = b.CreateSelect(b.CreateICmpEQ(next, b.getInt32(period)),
+                        b.getInt32(0), next);
+  b.CreateStore(next, clock);
+  llvm::Value *sampled = b.CreateICmpULT(
+      current, b.getInt32(opts::fProfileInstrSamplingBurst), "prof.sampled");
+
+  auto weights = llvm::MDBuilder(Fn->getContext())
+                     .createBranchWeights(opts::fProfileInstrSamplingBurst,
+                                          period -
+                                              opts::fProfileInstrSamplingBurst);
+  for (auto site : sites) {
+    auto term = llvm::SplitBlockAndInsertIfThen(sampled, site,
+                                                /*Unreachable=*/false, weights);
+    site->moveBefore(term);
+  }
+}
+
 void CodeGenPGO::loadRegionCounts(llvm::IndexedInstrProfReader *PGOReader,
                                   const FuncDeclaration *fd) {
   RegionCounts.clear();
@@ -19,9 +19,10 @@
 
 #include "gen/llvm.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include <array>
+#include <optional>
 #include <string>
 #include <vector>
-#include <array>
 
 namespace llvm {
 class GlobalVariable;
@@ -86,6 +87,21 @@ public:
 
   void emitCounterIncrement(const RootObject *S) const;
 
+  /// With -fprofile-instr-sampling-period, makes the counter increments and
+  /// value profiling of the (fully generated) function Fn conditional on the
+  /// invocation being sampled.
+  void emitSampling(llvm::Function *Fn) const;
+
+  /// Returns the entry count of function D in the profile data, or
+  /// std::nullopt if there is no (matching) data. For functions defined in
+  /// another module, with Name being their IR name there. D must have been
+  /// semantically analyzed.
+  static std::optional<uint64_t>
+  getExternalEntryCount(const FuncDeclaration *D, llvm::StringRef Name);
+
+  /// Returns whether Count is hot according to the profile summary.
+  static bool isHotCount(uint64_t Count);
+
   /// Return the region count for the counter at the given index.
   uint64_t getRegionCount(const RootObject *S) const {
     if (!RegionCounterMap)
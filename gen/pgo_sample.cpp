@@ -0,0 +1,156 @@
+//===-- pgo_sample.cpp ----------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/pgo_sample.h"
+
+#include "dmd/errors.h"
+#include "dmd/globals.h"
+#include "gen/logger.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Demangle/Demangle.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/ProfileData/SampleProfReader.h"
+#include "llvm/ProfileData/SampleProfWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include <cstdlib>
+
+using namespace llvm::sampleprof;
+
+std::string getCanonicalDName(llvm::StringRef mangledName) {
+  if (!mangledName.startswith("_D"))
+    return {};
+
+  char *demangled = llvm::dlangDemangle(mangledName.str().c_str());
+  if (!demangled)
+    return {};
+  std::string name = demangled;
+  std::free(demangled);
+
+  // e.g. `__lambda_L12_C5_1` (or `__lambda3` for older frontends) =>
+  // `__lambda`
+  static const llvm::Regex unstable(
+      "(__lambda|__dgliteral|__funcliteral|__foreachbody)"
+      "(_L[0-9]+_C[0-9]+(_[0-9]+)?|[0-9]+)");
+  llvm::SmallVector<llvm::StringRef, 4> matches;
+  std::string result;
+  llvm::StringRef rest = name;
+  while (unstable.match(rest, &matches)) {
+    const size_t start = matches[0].data() - rest.data();
+    result += rest.substr(0, start);
+    result += matches[1];
+    rest = rest.substr(start + matches[0].size());
+  }
+  result += rest;
+  return result;
+}
+
+namespace {
+llvm::StringRef getName(const FunctionSamples &samples) {
+#if LDC_LLVM_VER >= 1800
+  return samples.getFunction().stringRef();
+#else
+  return samples.getName();
+#endif
+}
+
+/// Maps canonical names to the unique name they were computed from, or to an
+/// empty string if ambiguous.
+void addCanonicalName(llvm::StringMap<llvm::StringRef> &map,
+                      llvm::StringRef name) {
+  const std::string canonical = getCanonicalDName(name);
+  if (canonical.empty())
+    return;
+  auto it = map.try_emplace(canonical, name);
+  if (!it.second)
+    it.first->second = llvm::StringRef();
+}
+} // anonymous namespace
+
+std::string remapSampleProfile(llvm::Module &M, const char *profilePath) {
+  llvm::LLVMContext context;
+  auto readerOrErr = SampleProfileReader::create(profilePath, context
+#if LDC_LLVM_VER >= 1600
+                                                 ,
+                                                 *llvm::vfs::getRealFileSystem()
+#endif
+  );
+  if (!readerOrErr) {
+    // reported by LLVM's sample profile loader
+    return {};
+  }
+  auto &reader = *readerOrErr.get();
+  if (reader.read() || reader.useMD5() || reader.profileIsCS())
+    return {};
+
+  auto &profiles = reader.getProfiles();
+
+  llvm::StringMap<llvm::StringRef> profileNames;
+  for (const auto &entry : profiles) {
+    const auto name = getName(entry.second);
+    if (!M.getFunction(name))
+      addCanonicalName(profileNames, name);
+  }
+
+  llvm::StringMap<llvm::StringRef> functionNames;
+  for (const auto &F : M) {
+    if (!F.isDeclaration() && !reader.getSamplesFor(F.getName()))
+      addCanonicalName(functionNames, F.getName());
+  }
+
+  llvm::BumpPtrAllocator allocator;
+  llvm::StringSaver saver(allocator);
+  unsigned numRenamed = 0;
+  for (const auto &entry : functionNames) {
+    const auto it = profileNames.find(entry.getKey());
+    if (entry.getValue().empty() || it == profileNames.end() ||
+        it->getValue().empty())
+      continue;
+
+    const auto oldName = it->getValue();
+    const auto newName = saver.save(entry.getValue());
+    IF_LOG Logger::println("Sample profile: matching %s to %s",
+                           oldName.str().c_str(), newName.str().c_str());
+
+#if LDC_LLVM_VER >= 1800
+    const SampleContext oldContext{FunctionId(oldName)};
+    FunctionSamples samples = profiles.at(oldContext);
+    profiles.erase(oldContext);
+    samples.setFunction(FunctionId(newName));
+    samples.setContext(SampleContext(FunctionId(newName)));
+    profiles.create(samples.getContext()) = std::move(samples);
+#else
+    const SampleContext oldContext(oldName);
+    FunctionSamples samples = profiles.at(oldContext);
+    profiles.erase(oldContext);
+    samples.setName(newName);
+    samples.setContext(SampleContext(newName));
+    profiles.emplace(samples.getContext(), std::move(samples));
+#endif
+    ++numRenamed;
+  }
+  if (numRenamed == 0)
+    return {};
+
+  llvm::SmallString<128> path;
+  if (llvm::sys::fs::createTemporaryFile("ldc-sample-profile", "prof", path))
+    return {};
+  auto writerOrErr = SampleProfileWriter::create(path, reader.getFormat());
+  if (!writerOrErr || writerOrErr.get()->write(profiles)) {
+    warning(Loc(), "Could not write remapped sample profile '%s'",
+            path.c_str());
+    llvm::sys::fs::remove(path);
+    return {};
+  }
+
+  return std::string(path.str());
+}
@@ -0,0 +1,37 @@
+//===-- gen/pgo_sample.h - Sample-based PGO helpers -------------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Matching of sample profiles (e.g., generated by ldc-profgen from perf data)
+// to the functions of a module by their D names, so that profiles remain
+// usable when unstable parts of symbol names change between builds.
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+namespace llvm {
+class Module;
+}
+
+/// Returns the demangled D name of `mangledName` without the parts which
+/// aren't stable across builds, i.e., the numbering and source locations of
+/// function literals and foreach bodies. Returns an empty string for non-D
+/// names.
+std::string getCanonicalDName(llvm::StringRef mangledName);
+
+/// Matches the top-level entries of the sample profile at `profilePath` to
+/// the functions defined in `M` by their canonical D names, for the entries
+/// and functions without exact match.
+/// Returns the path of a temporary copy of the profile with the matched
+/// entries renamed, to be removed by the caller, or an empty string if there
+/// are none.
+std::string remapSampleProfile(llvm::Module &M, const char *profilePath);
@@ -803,6 +803,9 @@ static void buildRuntimeModule() {
   // rt.sections_elf_shared.CompilerDSOData)
   createFwdDecl(LINK::c, voidTy, {"_d_dso_registry"}, {voidPtrTy});
 
+  // uint _d_cpu_features()
+  createFwdDecl(LINK::c, uintTy, {"_d_cpu_features"}, {}, {}, Attr_NoUnwind);
+
   //////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////////////
@@ -1274,7 +1274,7 @@ public:
           }
         }
 
-        p->ir->CreateCondBr(okCond, okbb, failbb);
+        markAsBoundsCheck(p->ir->CreateCondBr(okCond, okbb, failbb));
 
         p->ir->SetInsertPoint(failbb);
         emitArraySliceError(p, e->loc, vlo, vup,
@@ -23,12 +23,14 @@
 #include "gen/classes.h"
 #include "gen/complex.h"
 #include "gen/dvalue.h"
+#include "gen/funcgenstate.h"
 #include "gen/functions.h"
 #include "gen/irstate.h"
 #include "gen/linkage.h"
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
 #include "gen/logger.h"
+#include "gen/optimizer.h"
 #include "gen/pragma.h"
 #include "gen/runtime.h"
 #include "gen/structs.h"
@@ -566,6 +568,63 @@ void DtoAlignedStore(LLValue *src, LLValue *dst) {
   st->setAlignment(gDataLayout->getABITypeAlign(src->getType()));
 }
 
+// Attaches the TBAA access tag for D type `type` to the load or store `inst`
+// through `ptr` (with -fstrict-aliasing).
+void DtoApplyTBAA(llvm::Instruction *inst, Type *type, LLValue *ptr) {
+  if (!opts::fStrictAliasing || !isOptimizationEnabled() ||
+      (!gIR->funcGenStates.empty() &&
+       gIR->funcGen().unionFieldPointers.count(ptr))) {
+    return;
+  }
+
+  Type *t = type->toBasetype();
+  if (!t->isScalar() || t->ty == TY::Tvector)
+    return;
+
+  if (auto tag = getIrType(t, true)->getTBAAAccessTag())
+    inst->setMetadata(llvm::LLVMContext::MD_tbaa, tag);
+}
+
+// Removes all TBAA tags of the function being finished if a pointer to a union
+// field is used for anything but direct loads and stores, e.g., indexed (static
+// array fields), sliced, or taken the address of. Accesses through the derived
+// pointers could pun the union's memory with differently tagged types.
+void DtoFinalizeTBAA(llvm::Function *func) {
+  auto &unionFieldPointers = gIR->funcGen().unionFieldPointers;
+  if (unionFieldPointers.empty())
+    return;
+
+  const auto isDirectAccess = [](llvm::Value *ptr, llvm::User *user) {
+    if (llvm::isa<llvm::LoadInst>(user) || llvm::isa<llvm::MemIntrinsic>(user))
+      return true;
+    if (auto store = llvm::dyn_cast<llvm::StoreInst>(user))
+      return store->getValueOperand() != ptr;
+    if (auto intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(user))
+      return intrinsic->isLifetimeStartOrEnd();
+    return false;
+  };
+
+  bool escapes = false;
+  for (auto ptr : unionFieldPointers) {
+    for (auto user : ptr->users()) {
+      if (!isDirectAccess(ptr, user)) {
+        escapes = true;
+        break;
+      }
+    }
+    if (escapes)
+      break;
+  }
+  unionFieldPointers.clear();
+
+  if (escapes) {
+    for (auto &bb : *func) {
+      for (auto &inst : bb)
+        inst.setMetadata(llvm::LLVMContext::MD_tbaa, nullptr);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 LLType *stripAddrSpaces(LLType *t)
@@ -31,6 +31,7 @@
 #include "dmd/id.h"
 #include "dmd/import.h"
 #include "dmd/init.h"
+#include "dmd/ldcbindings.h"
 #include "dmd/mangle.h"
 #include "dmd/module.h"
 #include "dmd/mtype.h"
@@ -105,6 +106,35 @@ void emitTypeInfoMetadata(LLGlobalVariable *typeinfoGlobal, Type *forType) {
 
 /* ========================================================================= */
 
+llvm::Constant *getPointerBitmapRTInfo(Type *forType) {
+  const auto voidPtrTy = getOpaquePtrType();
+
+  Array<uint64_t> bitmap;
+  const uint64_t size = computePointerBitmap(forType, &bitmap);
+  if (size == UINT64_MAX) {
+    return llvm::ConstantExpr::getIntToPtr(DtoConstSize_t(1), voidPtrTy);
+  }
+  if (llvm::all_of(bitmap, [](uint64_t word) { return word == 0; })) {
+    return llvm::ConstantPointerNull::get(voidPtrTy);
+  }
+
+  // [T.sizeof, pointer bits...], like __traits(getPointerBitmap, T)
+  llvm::SmallVector<LLConstant *, 4> words;
+  words.push_back(DtoConstSize_t(size));
+  for (uint64_t word : bitmap) {
+    words.push_back(DtoConstSize_t(word));
+  }
+  auto type = LLArrayType::get(DtoSize_t(), words.size());
+  auto init = llvm::ConstantArray::get(type, words);
+  auto gvar = new llvm::GlobalVariable(gIR->module, type, true,
+                                       llvm::GlobalValue::PrivateLinkage, init,
+                                       ".pointerBitmap");
+  gvar->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+  return gvar;
+}
+
+/* ========================================================================= */
+
 namespace {
 // The upstream implementation is in dmd/todt.d, class TypeInfoDtVisitor.
 class DefineVisitor : public Visitor {
@@ -19,6 +19,7 @@ class Type;
 class TypeInfoDeclaration;
 
 namespace llvm {
+class Constant;
 class GlobalVariable;
 }
 
@@ -27,3 +28,9 @@ llvm::GlobalVariable *DtoResolveTypeInfo(TypeInfoDeclaration *tid);
 
 // Adds some metadata for use by optimization passes.
 void emitTypeInfoMetadata(llvm::GlobalVariable *typeinfoGlobal, Type *forType);
+
+/// Returns the `immutable(void)* m_RTInfo` value for an aggregate type without
+/// RTInfo from object.RTInfo: a pointer to its pointer bitmap in the format of
+/// object.RTInfoImpl, null if it has no pointers, or 1 (scan conservatively) if
+/// the bitmap cannot be computed.
+llvm::Constant *getPointerBitmapRTInfo(Type *forType);
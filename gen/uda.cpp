@@ -12,6 +12,7 @@
 #include "gen/irstate.h"
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
+#include "gen/multiversioning.h"
 #include "ir/irfunction.h"
 #include "ir/irvar.h"
 #include "llvm/ADT/StringExtras.h"
@@ -376,6 +377,34 @@ void applyAttrTarget(StructLiteralExp *sle, llvm::Function *func,
 #endif
 }
 
+// @target_clones("default", "avx2", ...)
+void applyAttrTargetClones(StructLiteralExp *sle, IrFunction *irFunc) {
+  ArrayLiteralExp *ale = nullptr;
+  if (sle->elements->length == 1 && (*sle->elements)[0])
+    ale = (*sle->elements)[0]->isArrayLiteralExp();
+  if (!ale) {
+    error(sle->loc,
+          "unexpected fields in `%s`; does druntime not match compiler "
+          "version?",
+          sle->sd->toPrettyChars());
+    fatal();
+  }
+
+  llvm::SmallVector<llvm::StringRef, 4> targets;
+  for (size_t i = 0; i < ale->elements->length; ++i) {
+    auto strexp = ale->getElement(i)->isStringExp();
+    if (!strexp) {
+      error(sle->loc, "`@ldc.attributes.%s` expects string literals",
+            sle->sd->ident->toChars());
+      return;
+    }
+    DString str = strexp->peekString();
+    targets.emplace_back(str.ptr, str.length);
+  }
+
+  registerTargetClones(*gIR, sle->loc, irFunc->getLLVMFunc(), targets);
+}
+
 void applyAttrAssumeUsed(IRState &irs, StructLiteralExp *sle,
                          llvm::Constant *symbol) {
   checkStructElems(sle, {});
@@ -497,7 +526,8 @@ void applyVarDeclUDAs(VarDeclaration *decl, llvm::GlobalVariable *gvar) {
     } else if (ident == Id::udaHidden) {
       if (!decl->isExport()) // export visibility is stronger
         gvar->setVisibility(LLGlobalValue::HiddenVisibility);
-    } else if (ident == Id::udaOptStrategy || ident == Id::udaTarget) {
+    } else if (ident == Id::udaOptStrategy || ident == Id::udaTarget ||
+               ident == Id::udaTargetClones) {
       error(sle->loc,
             "special attribute `ldc.attributes.%s` is only valid for functions",
             ident->toChars());
@@ -552,6 +582,8 @@ void applyFuncDeclUDAs(FuncDeclaration *decl, IrFunction *irFunc) {
         applyAttrSection(sle, func);
       } else if (ident == Id::udaTarget) {
         applyAttrTarget(sle, func, irFunc);
+      } else if (ident == Id::udaTargetClones) {
+        applyAttrTargetClones(sle, irFunc);
       } else if (ident == Id::udaAssumeUsed) {
         applyAttrAssumeUsed(*gIR, sle, func);
       } else if (ident == Id::udaWeak || ident == Id::udaKernel ||
@@ -677,6 +709,12 @@ bool hasNoSplitStackUDA(FuncDeclaration *fd) {
   return sle != nullptr;
 }
 
+/// Check whether `fd` has the `@ldc.attributes.target_clones` UDA applied.
+bool hasTargetClonesUDA(FuncDeclaration *fd) {
+  auto sle = getMagicAttribute(fd, Id::udaTargetClones, Id::attributes);
+  return sle != nullptr;
+}
+
 /// Creates a mask (for &) of @ldc.attributes.noSanitize UDA applied to the
 /// function.
 /// If a bit is set in the mask, then the sanitizer is enabled.
@@ -39,5 +39,6 @@ enum class DComputeCompileFor : int
 };
 extern "C" DComputeCompileFor hasComputeAttr(Dsymbol *sym);
 bool hasNoSplitStackUDA(FuncDeclaration *fd);
+bool hasTargetClonesUDA(FuncDeclaration *fd);
 
 unsigned getMaskFromNoSanitizeUDA(FuncDeclaration &fd);
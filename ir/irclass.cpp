@@ -436,6 +436,8 @@ LLConstant *IrClass::getClassInfoInit() {
     b.push(toConstElem(cd->getRTInfo, gIR));
   } else if (isInterface || (flags & ClassFlags::noPointers)) {
     b.push_size_as_vp(0); // no pointers
+  } else if (global.params.useTypeInfo && Type::rtinfo) {
+    b.push(getPointerBitmapRTInfo(cd->type));
   } else {
     b.push_size_as_vp(1); // has pointers
   }
@@ -186,6 +186,9 @@ LLConstant *IrStruct::getTypeInfoInit() {
   // immutable(void)* m_RTInfo
   if (!isOpaque && sd->getRTInfo) {
     b.push(toConstElem(sd->getRTInfo, gIR));
+  } else if (!isOpaque && global.params.useTypeInfo && Type::rtinfo) {
+    // RTInfo!S hasn't been instantiated (e.g., no semantic3 for this module)
+    b.push(getPointerBitmapRTInfo(ts));
   } else {
     b.push_size_as_vp(!isOpaque && hasPointers(ts) ? 1 : 0);
   }
@@ -18,6 +18,7 @@
 #include "gen/tollvm.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/MDBuilder.h"
 
 // These functions use getGlobalContext() as they are invoked before gIR
 // is set.
@@ -32,6 +33,18 @@ IrFuncTy &IrType::getIrFuncTy() {
   llvm_unreachable("cannot get IrFuncTy from non lazy/function/delegate");
 }
 
+// The TBAA type tree has an "omnipotent char" node below the root, which
+// aliases everything, and one node per scalar representation below that.
+// Integers differing only in signedness share a node, just like in C.
+// The metadata nodes are uniqued by LLVM, so there's no need to cache them.
+llvm::MDNode *IrType::getTBAAScalarAccessTag(const char *name) {
+  llvm::MDBuilder mdb(getGlobalContext());
+  auto root = mdb.createTBAARoot("D TBAA");
+  auto omnipotentChar = mdb.createTBAAScalarTypeNode("omnipotent char", root);
+  auto node = mdb.createTBAAScalarTypeNode(name, omnipotentChar);
+  return mdb.createTBAAStructTagNode(node, node, 0);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 IrTypeBasic::IrTypeBasic(Type *dt) : IrType(dt, basic2llvm(dt)) {}
@@ -106,6 +119,38 @@ llvm::Type *IrTypeBasic::basic2llvm(Type *t) {
   }
 }
 
+llvm::MDNode *IrTypeBasic::getTBAAAccessTag() {
+  // 8-bit types (incl. bool) may alias anything, complex numbers are
+  // aggregates.
+  switch (dtype->ty) {
+  case TY::Tint16:
+  case TY::Tuns16:
+  case TY::Twchar:
+    return getTBAAScalarAccessTag("short");
+  case TY::Tint32:
+  case TY::Tuns32:
+  case TY::Tdchar:
+    return getTBAAScalarAccessTag("int");
+  case TY::Tint64:
+  case TY::Tuns64:
+    return getTBAAScalarAccessTag("long");
+  case TY::Tint128:
+  case TY::Tuns128:
+    return getTBAAScalarAccessTag("cent");
+  case TY::Tfloat32:
+  case TY::Timaginary32:
+    return getTBAAScalarAccessTag("float");
+  case TY::Tfloat64:
+  case TY::Timaginary64:
+    return getTBAAScalarAccessTag("double");
+  case TY::Tfloat80:
+  case TY::Timaginary80:
+    return getTBAAScalarAccessTag("real");
+  default:
+    return nullptr;
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 IrTypePointer::IrTypePointer(Type *dt, LLType *lt) : IrType(dt, lt) {}
@@ -127,6 +172,11 @@ IrTypePointer *IrTypePointer::get(Type *dt) {
   return t;
 }
 
+llvm::MDNode *IrTypePointer::getTBAAAccessTag() {
+  // like clang, don't distinguish between pointee types
+  return getTBAAScalarAccessTag("any pointer");
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 IrTypeSArray::IrTypeSArray(Type *dt, LLType *lt) : IrType(dt, lt) {}
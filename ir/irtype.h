@@ -22,6 +22,7 @@
 
 namespace llvm {
 class LLVMContext;
+class MDNode;
 class Type;
 }
 
@@ -89,10 +90,17 @@ public:
   ///
   virtual IrFuncTy &getIrFuncTy();
 
+  /// Returns the TBAA access tag for scalar loads and stores of this type, or
+  /// null if they may alias objects of any type.
+  virtual llvm::MDNode *getTBAAAccessTag() { return nullptr; }
+
 protected:
   ///
   IrType(Type *dt, llvm::Type *lt);
 
+  ///
+  static llvm::MDNode *getTBAAScalarAccessTag(const char *name);
+
   ///
   Type *dtype = nullptr;
 
@@ -111,6 +119,9 @@ public:
   ///
   IrTypeBasic *isBasic() override { return this; }
 
+  ///
+  llvm::MDNode *getTBAAAccessTag() override;
+
 protected:
   ///
   explicit IrTypeBasic(Type *dt);
@@ -131,6 +142,9 @@ public:
   ///
   IrTypePointer *isPointer() override { return this; }
 
+  ///
+  llvm::MDNode *getTBAAAccessTag() override;
+
 protected:
   ///
   IrTypePointer(Type *dt, llvm::Type *lt);
@@ -12,6 +12,7 @@
 #include "dmd/declaration.h"
 #include "dmd/errors.h"
 #include "dmd/init.h"
+#include "driver/cl_options.h"
 #include "gen/dynamiccompile.h"
 #include "gen/irstate.h"
 #include "gen/llvm.h"
@@ -142,6 +143,16 @@ void IrGlobal::define() {
   gvar = gIR->setGlobalVarInitializer(gvar, initVal, V);
   value = gvar;
 
+  // With -ftls-noscan, zero-initialized thread-locals without pointers are
+  // collected in a TLS section bracketed by linker-generated
+  // __start_/__stop_ symbols, which druntime (rt.dso) excludes from the
+  // TLS ranges scanned by the GC.
+  if (opts::fTLSNoScan && V->isThreadlocal() && !gvar->hasSection() &&
+      global.params.targetTriple->isOSBinFormatELF() &&
+      initVal->isNullValue() && !V->hasPointers()) {
+    gvar->setSection("__d_tls_noscan");
+  }
+
   // dllexport isn't supported for thread-local globals (MSVC++ neither);
   // don't let LLVM create a useless /EXPORT directive (yields the same linker
   // error anyway when trying to dllimport).